@@ -0,0 +1,229 @@
+#pragma once
+#include "ParameterTraits.h"
+#include "ParamMessage.h"
+#include "RejectLog.h"
+#include "SPSCQueue.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#include <coroutine>
+#include <exception>
+#define PARAMETER_TRAITS_HAS_COROUTINES 1
+#endif
+#endif
+
+//
+// Awaitable parameter updates.
+//
+// An update whose outcome is wanted goes out as a two-message run, a
+// Ticket marker then the SetParam, pushed with one try_push_all so it
+// stays contiguous. Once the batch holding it has been applied (and
+// committed and published), the worker pushes a Completion for the
+// ticket into the WorkerConfig::completions ring, where one client
+// thread collects it with AsyncParamClient::poll().
+//
+// In C++20 builds (PARAMETER_TRAITS_CXX20) that resumes a coroutine:
+//
+//   DetachedTask apply_recipe(AsyncParamClient<Worker>& client)
+//   {
+//       UpdateResult r = co_await client.set_param(TemperatureSetpoint{ 42.0f });
+//       if (!r) ...
+//   }
+//
+// In any build, submit() takes a plain callback instead and
+// set_param_sync() blocks the caller until the result arrives. Either
+// way one thread can have thousands of updates in flight.
+//
+struct Completion
+{
+    uint32_t     ticket  = 0;
+    ParameterID  id{};       // a BlobID (cast) for a SetBlob update
+    bool         applied = false;
+    RejectReason reason{};   // when not applied; BlobRejected for blobs
+};
+
+// One ring per client. A client never has more tickets out than the
+// ring holds, so the worker always finds room.
+static constexpr std::size_t kCompletionRingSize = 4096;
+using CompletionRing = SPSCQueue<Completion, kCompletionRingSize, QueueLayout::CacheAligned>;
+
+enum class UpdateStatus : uint8_t
+{
+    Applied,
+    Rejected,    // see reason
+    NotQueued    // queue full or no free ticket; nothing was sent
+};
+
+struct UpdateResult
+{
+    UpdateStatus status = UpdateStatus::NotQueued;
+    RejectReason reason{};
+
+    explicit operator bool() const { return status == UpdateStatus::Applied; }
+};
+
+#if defined(PARAMETER_TRAITS_HAS_COROUTINES)
+//
+// Minimal eager, fire-and-forget coroutine type: runs until its first
+// suspension when called and frees itself when it finishes.
+//
+struct DetachedTask
+{
+    struct promise_type
+    {
+        DetachedTask get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+#endif
+
+//
+// Producer-side handle that tracks outcomes. Sink is a ParamWorker
+// (anything with try_post_all(Msg*, n)); its WorkerConfig::completions
+// must point at ring. Use a client, and its ring, from one thread only.
+// A ParamRouter is not a valid Sink; see ParamPool.h.
+//
+template <typename Sink, std::size_t MaxInFlight = kCompletionRingSize - 1>
+class AsyncParamClient
+{
+    static_assert(MaxInFlight > 0 && MaxInFlight < kCompletionRingSize,
+                  "More tickets than the completion ring can hold.");
+
+public:
+    using Callback = void (*)(void* ctx, const UpdateResult& result);
+
+    AsyncParamClient(Sink& sink, CompletionRing& ring) : sink_(sink), ring_(ring)
+    {
+        for (std::size_t i = 0; i < MaxInFlight; ++i) free_[i] = static_cast<uint32_t>(MaxInFlight - 1 - i);
+        freeCount_ = MaxInFlight;
+    }
+
+    AsyncParamClient(const AsyncParamClient&) = delete;
+    AsyncParamClient& operator=(const AsyncParamClient&) = delete;
+
+    //
+    // Send m; cb(ctx, result) runs from a later poll() once the worker
+    // has applied or rejected it. Returns false (and never calls cb) if
+    // nothing could be sent.
+    //
+    bool submit(const Msg& m, Callback cb, void* ctx = nullptr)
+    {
+        if (freeCount_ == 0) return false;
+        const uint32_t t = free_[freeCount_ - 1];
+        Msg run[2] = { Msg{ Ticket{ t } }, m };
+        if (!sink_.try_post_all(run, 2)) return false;
+        --freeCount_;
+        waiters_[t] = Waiter{ cb, ctx };
+        return true;
+    }
+
+    template <typename Tag>
+    bool submit(const Tag& value, Callback cb, void* ctx = nullptr)
+    {
+        return submit(Msg{ SetParam<Tag>{ value } }, cb, ctx);
+    }
+
+    //
+    // Deliver up to max completions. Callbacks (and coroutines) run
+    // here, on the calling thread, and may submit more updates.
+    //
+    std::size_t poll(std::size_t max = 64)
+    {
+        // Copied out first so a resumed coroutine may poll again.
+        std::array<Completion, 64> done;
+        const std::size_t n = ring_.pop_bulk(done.data(), max < done.size() ? max : done.size());
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            const Completion& c = done[i];
+            const Waiter w = waiters_[c.ticket];
+            free_[freeCount_++] = c.ticket;
+            const UpdateResult r{ c.applied ? UpdateStatus::Applied : UpdateStatus::Rejected, c.reason };
+            if (w.cb) w.cb(w.ctx, r);
+        }
+        return n;
+    }
+
+    std::size_t in_flight() const { return MaxInFlight - freeCount_; }
+
+    // C++17 fallback: send and poll (yielding) until the result is in.
+    // Completions for other updates are delivered on the way.
+    template <typename Tag>
+    UpdateResult set_param_sync(const Tag& value)
+    {
+        struct Slot
+        {
+            UpdateResult result;
+            bool done = false;
+        } slot;
+        const bool sent = submit(value, [](void* ctx, const UpdateResult& r)
+        {
+            auto* s = static_cast<Slot*>(ctx);
+            s->result = r;
+            s->done = true;
+        }, &slot);
+        if (!sent) return UpdateResult{};
+        while (!slot.done)
+        {
+            if (poll() == 0) std::this_thread::yield();
+        }
+        return slot.result;
+    }
+
+#if defined(PARAMETER_TRAITS_HAS_COROUTINES)
+    template <typename Tag>
+    class Awaiter
+    {
+    public:
+        Awaiter(AsyncParamClient& client, const Tag& value) : client_(client), value_(value) {}
+
+        // Suspends only if the update was sent; otherwise resumes at once
+        // with NotQueued.
+        bool await_ready() const noexcept { return false; }
+
+        bool await_suspend(std::coroutine_handle<> h)
+        {
+            handle_ = h;
+            return client_.submit(value_, &Awaiter::resume, this);
+        }
+
+        UpdateResult await_resume() const noexcept { return result_; }
+
+    private:
+        static void resume(void* ctx, const UpdateResult& r)
+        {
+            auto* a = static_cast<Awaiter*>(ctx);
+            a->result_ = r;
+            a->handle_.resume();
+        }
+
+        AsyncParamClient&       client_;
+        Tag                     value_;
+        std::coroutine_handle<> handle_;
+        UpdateResult            result_;
+    };
+
+    // co_await client.set_param(value) -> UpdateResult
+    template <typename Tag>
+    Awaiter<Tag> set_param(const Tag& value) { return Awaiter<Tag>(*this, value); }
+#endif
+
+private:
+    struct Waiter
+    {
+        Callback cb  = nullptr;
+        void*    ctx = nullptr;
+    };
+
+    Sink&           sink_;
+    CompletionRing& ring_;
+    std::array<Waiter, MaxInFlight>   waiters_{};
+    std::array<uint32_t, MaxInFlight> free_{};
+    std::size_t freeCount_ = 0;
+};
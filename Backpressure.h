@@ -0,0 +1,205 @@
+#pragma once
+#include "ParameterTraits.h"
+#include "ParamMessage.h"
+#include "Platform.h"
+#include "Seqlock.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+//
+// Side channel for Backpressure::Coalesce.
+//
+// The producer writes the newest value for an id into its slot and
+// only enqueues a MsgKind::Conflated marker if none is outstanding. The
+// worker clears the pending flag when the marker arrives and then reads
+// whatever value is newest, so any number of updates made while the
+// marker sat in the queue cost one slot write each and one apply.
+//
+// Slots are single-writer: give each producer thread its own
+// ConflationSlots (and its own worker) if more than one thread coalesces.
+//
+class ConflationSlots
+{
+public:
+    // Producer side. Returns true when the caller must enqueue a marker.
+    bool stage(ParameterID id, const void* value, std::size_t size)
+    {
+        const auto i = static_cast<std::size_t>(id);
+        Slot s{};
+        std::memcpy(s.bytes, value, size);
+        slots_[i].publish(s);
+        return !pending_[i].exchange(true, std::memory_order_acq_rel);
+    }
+
+    // Producer side: the marker could not be queued.
+    void cancel(ParameterID id)
+    {
+        pending_[static_cast<std::size_t>(id)].store(false, std::memory_order_release);
+    }
+
+    // Worker side, on receipt of the marker. Clearing the flag first
+    // means an update racing with us either lands in what we read or
+    // enqueues a fresh marker.
+    void take(ParameterID id, void* out)
+    {
+        const auto i = static_cast<std::size_t>(id);
+        pending_[i].exchange(false, std::memory_order_acq_rel);
+        const Slot s = slots_[i].read();
+        std::memcpy(out, s.bytes, sizeof(s.bytes));
+    }
+
+private:
+    struct Slot
+    {
+        alignas(kMaxParameterAlign) unsigned char bytes[kMaxParameterSize];
+    };
+
+    std::array<Seqlock<Slot>, registryCount> slots_;
+    std::array<std::atomic<bool>, registryCount> pending_{};
+};
+
+//
+// Producer-side wrapper that applies a Backpressure policy instead of
+// letting a full queue silently drop updates. Sink is anything with
+// try_post(const Msg&), normally a ParamWorker.
+//
+// post() picks the policy declared by each parameter's traits; the
+// post_blocking / post_overwrite / post_coalesced calls force one.
+// A ParamProducer belongs to one thread.
+//
+template <typename Sink, std::size_t OverflowPow2 = 64>
+class ParamProducer
+{
+    static_assert((OverflowPow2 & (OverflowPow2 - 1)) == 0, "Overflow capacity must be power of two.");
+
+public:
+    explicit ParamProducer(Sink& sink,
+                           ConflationSlots* slots = nullptr,
+                           std::chrono::microseconds block_timeout = std::chrono::milliseconds(1))
+        : sink_(sink), slots_(slots), timeout_(block_timeout)
+    {
+    }
+
+    template <typename Tag>
+    bool post(const Tag& value)
+    {
+        return post(Msg{ SetParam<Tag>{ value } });
+    }
+
+    bool post(const Msg& m)
+    {
+        if (m.kind == MsgKind::Stop) return flush_blocking() && post_blocking(m);
+        // Dropping or replacing a blob handle would leak its pool slot.
+        if (m.kind == MsgKind::SetBlob) return post_blocking(m);
+
+        const Handler* h = find_by_id(m.id);
+        switch (h ? h->backpressure : Backpressure::Block)
+        {
+        case Backpressure::OverwriteOldest: return post_overwrite(m);
+        case Backpressure::Coalesce:        return post_coalesced(m);
+        case Backpressure::Block:           break;
+        }
+        return post_blocking(m);
+    }
+
+    // Retry for up to the block timeout: spin briefly, then yield.
+    bool post_blocking(const Msg& m)
+    {
+        flush();
+        for (unsigned i = 0; i < kSpin; ++i)
+        {
+            if (sink_.try_post(m)) return true;
+            detail::cpu_relax();
+        }
+        const auto deadline = std::chrono::steady_clock::now() + timeout_;
+        while (!sink_.try_post(m))
+        {
+            if (std::chrono::steady_clock::now() >= deadline) return false;
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+    //
+    // Never fails. While the queue is full (or older overflow is still
+    // waiting) updates go to the overflow ring, which drops its oldest
+    // entry when it fills up. Overflow is drained, in order, by the next
+    // post or flush().
+    //
+    bool post_overwrite(const Msg& m)
+    {
+        if (flush() && sink_.try_post(m)) return true;
+        if (overflowCount_ == OverflowPow2)
+        {
+            overflowHead_ = (overflowHead_ + 1) & kOverflowMask;
+            --overflowCount_;
+            ++overwritten_;
+        }
+        overflow_[(overflowHead_ + overflowCount_) & kOverflowMask] = m;
+        ++overflowCount_;
+        return true;
+    }
+
+    //
+    // Stage the value in its conflation slot and enqueue a marker only if
+    // none is outstanding. Falls back to post_blocking without slots.
+    // Returns false if a needed marker could not be queued in time; the
+    // value stays staged and goes out with the next update of that id.
+    //
+    bool post_coalesced(const Msg& m)
+    {
+        if (!slots_) return post_blocking(m);
+        if (!slots_->stage(m.id, m.payload, sizeof(m.payload))) return true;
+
+        Msg marker = m;
+        marker.kind = MsgKind::Conflated;
+        if (post_blocking(marker)) return true;
+        slots_->cancel(m.id);
+        return false;
+    }
+
+    // Push as much overflow as fits; true once the overflow is empty.
+    bool flush()
+    {
+        while (overflowCount_ && sink_.try_post(overflow_[overflowHead_]))
+        {
+            overflowHead_ = (overflowHead_ + 1) & kOverflowMask;
+            --overflowCount_;
+        }
+        return overflowCount_ == 0;
+    }
+
+    std::size_t pending_overflow() const { return overflowCount_; }
+
+    // Overflow entries discarded by OverwriteOldest so far.
+    uint64_t overwritten() const { return overwritten_; }
+
+private:
+    static constexpr unsigned    kSpin         = 256;
+    static constexpr std::size_t kOverflowMask = OverflowPow2 - 1;
+
+    bool flush_blocking()
+    {
+        const auto deadline = std::chrono::steady_clock::now() + timeout_;
+        while (!flush())
+        {
+            if (std::chrono::steady_clock::now() >= deadline) return false;
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+    Sink& sink_;
+    ConflationSlots* slots_;
+    std::chrono::microseconds timeout_;
+
+    std::array<Msg, OverflowPow2> overflow_{};
+    std::size_t overflowHead_  = 0;
+    std::size_t overflowCount_ = 0;
+    uint64_t    overwritten_   = 0;
+};
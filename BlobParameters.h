@@ -0,0 +1,176 @@
+#pragma once
+#include "ParameterSchema.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+//
+// Variable-length parameter identities, generated from
+// PARAMETER_TRAITS_BLOB_SCHEMA. A separate id space from ParameterID:
+// blobs have no Handler, no slot in ParameterTable and no binary record.
+//
+enum class BlobID : uint16_t
+{
+#define PARAMETER_TRAITS_GEN_BLOB_ID(Tag, E, cap) Tag,
+    PARAMETER_TRAITS_BLOB_SCHEMA(PARAMETER_TRAITS_GEN_BLOB_ID)
+#undef PARAMETER_TRAITS_GEN_BLOB_ID
+};
+
+#define PARAMETER_TRAITS_GEN_BLOB_TAG(Tag, E, cap) struct Tag {};
+PARAMETER_TRAITS_BLOB_SCHEMA(PARAMETER_TRAITS_GEN_BLOB_TAG)
+#undef PARAMETER_TRAITS_GEN_BLOB_TAG
+
+template <typename T>
+struct BlobTraits;
+
+#define PARAMETER_TRAITS_GEN_BLOB_TRAITS(Tag, E, cap)                                       \
+    template <>                                                                             \
+    struct BlobTraits<Tag>                                                                  \
+    {                                                                                       \
+        using Element = E;                                                                  \
+        static constexpr BlobID id = BlobID::Tag;                                           \
+        static constexpr std::string_view name = #Tag;                                      \
+        static constexpr std::size_t capacity = cap;                                        \
+        static_assert(std::is_trivially_copyable_v<E>, "Blob elements travel as raw bytes."); \
+    };
+PARAMETER_TRAITS_BLOB_SCHEMA(PARAMETER_TRAITS_GEN_BLOB_TRAITS)
+#undef PARAMETER_TRAITS_GEN_BLOB_TRAITS
+
+template <typename T>
+constexpr BlobID blob_id() { return BlobTraits<T>::id; }
+
+//
+// Runtime description of a blob parameter, in BlobID order.
+//
+struct BlobHandler
+{
+    BlobID      id;
+    const char* name;
+    std::size_t element_size;
+    std::size_t element_align;
+    std::size_t capacity;   // elements
+
+    constexpr std::size_t max_bytes() const { return element_size * capacity; }
+
+    // A value of n bytes is a whole number of elements within capacity.
+    constexpr bool fits(std::size_t n) const { return n <= max_bytes() && n % element_size == 0; }
+};
+
+#define PARAMETER_TRAITS_GEN_BLOB_HANDLER(Tag, E, cap) \
+    BlobHandler{ BlobID::Tag, #Tag, sizeof(E), alignof(E), cap },
+static constexpr BlobHandler blobRegistry[] = {
+    PARAMETER_TRAITS_BLOB_SCHEMA(PARAMETER_TRAITS_GEN_BLOB_HANDLER)
+};
+#undef PARAMETER_TRAITS_GEN_BLOB_HANDLER
+
+static constexpr auto blobRegistryCount = std::size(blobRegistry);
+
+namespace detail
+{
+constexpr std::size_t max_blob_bytes()
+{
+    std::size_t m = 0;
+    for (auto const& b : blobRegistry) m = b.max_bytes() > m ? b.max_bytes() : m;
+    return m;
+}
+
+constexpr std::size_t max_blob_align()
+{
+    std::size_t m = 1;
+    for (auto const& b : blobRegistry) m = b.element_align > m ? b.element_align : m;
+    return m;
+}
+
+// Where each blob's region starts in BlobTable storage.
+constexpr std::array<std::size_t, blobRegistryCount> blob_offsets()
+{
+    std::array<std::size_t, blobRegistryCount> offsets{};
+    std::size_t at = 0;
+    for (std::size_t i = 0; i < blobRegistryCount; ++i)
+    {
+        const std::size_t align = blobRegistry[i].element_align;
+        at = (at + align - 1) / align * align;
+        offsets[i] = at;
+        at += blobRegistry[i].max_bytes();
+    }
+    return offsets;
+}
+}
+
+static constexpr std::size_t kMaxBlobBytes = detail::max_blob_bytes();
+static constexpr std::size_t kMaxBlobAlign = detail::max_blob_align();
+
+constexpr const BlobHandler* find_blob(BlobID id)
+{
+    const auto i = static_cast<std::size_t>(id);
+    return i < blobRegistryCount ? &blobRegistry[i] : nullptr;
+}
+
+// Read-only view of a blob value.
+template <typename E>
+struct BlobRef
+{
+    const E*    data = nullptr;
+    std::size_t size = 0;   // elements
+};
+
+//
+// Current value of every blob parameter, each in its own fixed
+// capacity region, so setting one never allocates. Written by the
+// worker; read it from the worker thread (e.g. in a subscriber) or once
+// the worker has stopped. All values start out empty.
+//
+class BlobTable
+{
+public:
+    // Returns false (leaving the value as it was) if n bytes do not fit.
+    bool set(BlobID id, const void* bytes, std::size_t n)
+    {
+        const BlobHandler* b = find_blob(id);
+        if (!b || !b->fits(n)) return false;
+        const auto i = static_cast<std::size_t>(id);
+        std::memcpy(storage_ + offsets_[i], bytes, n);
+        sizes_[i] = n;
+        return true;
+    }
+
+    template <typename Tag>
+    bool set(const typename BlobTraits<Tag>::Element* data, std::size_t count)
+    {
+        return set(blob_id<Tag>(), data, count * sizeof(typename BlobTraits<Tag>::Element));
+    }
+
+    const void* data(BlobID id) const { return storage_ + offsets_[static_cast<std::size_t>(id)]; }
+    std::size_t bytes(BlobID id) const { return sizes_[static_cast<std::size_t>(id)]; }
+
+    template <typename Tag>
+    BlobRef<typename BlobTraits<Tag>::Element> get() const
+    {
+        using E = typename BlobTraits<Tag>::Element;
+        constexpr BlobID id = blob_id<Tag>();
+        return { reinterpret_cast<const E*>(storage_ + offsets_[static_cast<std::size_t>(id)]), bytes(id) / sizeof(E) };
+    }
+
+private:
+    static constexpr std::array<std::size_t, blobRegistryCount> offsets_ = detail::blob_offsets();
+    static constexpr std::size_t storageSize =
+        offsets_[blobRegistryCount - 1] + blobRegistry[blobRegistryCount - 1].max_bytes();
+
+    alignas(kMaxBlobAlign) unsigned char storage_[storageSize]{};
+    std::array<std::size_t, blobRegistryCount> sizes_{};
+};
+
+namespace detail
+{
+constexpr bool blob_registry_in_id_order()
+{
+    for (std::size_t i = 0; i < blobRegistryCount; ++i)
+        if (static_cast<std::size_t>(blobRegistry[i].id) != i) return false;
+    return true;
+}
+}
+
+static_assert(detail::blob_registry_in_id_order(), "blobRegistry[] entries must be listed in BlobID order.");
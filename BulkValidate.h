@@ -0,0 +1,105 @@
+#pragma once
+#include "Platform.h"
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+//
+// Range-check kernels behind validate_bulk().
+//
+// Each kernel checks lo <= v[i] <= hi for a contiguous array and sets
+// bit i of mask (mask[i / 64], bit i % 64) for every rejected value.
+// NaN fails both comparisons and is rejected, like the scalar
+// validate(). mask must hold (n + 63) / 64 words; all of them are
+// written. Returns the number of rejected values.
+//
+// The float kernel uses AVX, SSE2 or AArch64 NEON, whichever the build
+// targets, and a scalar loop for the tail and everything else.
+//
+namespace detail
+{
+template <typename U>
+constexpr bool in_bounds(U v, U lo, U hi)
+{
+    return v >= lo && v <= hi;
+}
+
+template <typename U>
+inline size_t reject_scalar(const U* v, size_t first, size_t n, U lo, U hi, uint64_t* mask)
+{
+    size_t rejected = 0;
+    for (size_t i = first; i < n; ++i)
+    {
+        if (!in_bounds(v[i], lo, hi))
+        {
+            mask[i / 64] |= uint64_t{1} << (i % 64);
+            ++rejected;
+        }
+    }
+    return rejected;
+}
+
+inline void clear_mask(uint64_t* mask, size_t n)
+{
+    for (size_t w = 0; w < (n + 63) / 64; ++w) mask[w] = 0;
+}
+
+template <typename U>
+inline size_t reject_mask(const U* v, size_t n, U lo, U hi, uint64_t* mask)
+{
+    clear_mask(mask, n);
+    return reject_scalar(v, 0, n, lo, hi, mask);
+}
+
+inline size_t reject_mask(const float* v, size_t n, float lo, float hi, uint64_t* mask)
+{
+    clear_mask(mask, n);
+    size_t i = 0;
+    size_t rejected = 0;
+
+#if defined(__AVX__)
+    const __m256 vlo = _mm256_set1_ps(lo);
+    const __m256 vhi = _mm256_set1_ps(hi);
+    for (; i + 8 <= n; i += 8)
+    {
+        const __m256 x  = _mm256_loadu_ps(v + i);
+        const __m256 ok = _mm256_and_ps(_mm256_cmp_ps(x, vlo, _CMP_GE_OQ), _mm256_cmp_ps(x, vhi, _CMP_LE_OQ));
+        const uint64_t bad = ~static_cast<uint64_t>(_mm256_movemask_ps(ok)) & 0xFFu;
+        // i is a multiple of 8, so the 8 bits never straddle two words.
+        mask[i / 64] |= bad << (i % 64);
+        rejected += static_cast<size_t>(popcount(bad));
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    const __m128 vlo = _mm_set1_ps(lo);
+    const __m128 vhi = _mm_set1_ps(hi);
+    for (; i + 4 <= n; i += 4)
+    {
+        const __m128 x  = _mm_loadu_ps(v + i);
+        const __m128 ok = _mm_and_ps(_mm_cmpge_ps(x, vlo), _mm_cmple_ps(x, vhi));
+        const uint64_t bad = ~static_cast<uint64_t>(_mm_movemask_ps(ok)) & 0xFu;
+        mask[i / 64] |= bad << (i % 64);
+        rejected += static_cast<size_t>(popcount(bad));
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    const float32x4_t vlo = vdupq_n_f32(lo);
+    const float32x4_t vhi = vdupq_n_f32(hi);
+    const uint32_t    laneBits[4] = { 1, 2, 4, 8 };
+    const uint32x4_t  bits = vld1q_u32(laneBits);
+    for (; i + 4 <= n; i += 4)
+    {
+        const float32x4_t x  = vld1q_f32(v + i);
+        const uint32x4_t  ok = vandq_u32(vcgeq_f32(x, vlo), vcleq_f32(x, vhi));
+        const uint64_t bad = ~static_cast<uint64_t>(vaddvq_u32(vandq_u32(ok, bits))) & 0xFu;
+        mask[i / 64] |= bad << (i % 64);
+        rejected += static_cast<size_t>(popcount(bad));
+    }
+#endif
+
+    return rejected + reject_scalar(v, i, n, lo, hi, mask);
+}
+}
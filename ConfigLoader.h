@@ -0,0 +1,176 @@
+#pragma once
+#include "ParameterTraits.h"
+#include "ParameterTable.h"
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//
+// Bulk text configuration loader.
+//
+// Input is one "name = value" pair per line; blank lines and lines whose
+// first non-blank character is '#' are ignored. The file is mapped
+// read-only and tokenized in place: names resolve through find_by_name
+// and values go straight from the mapping to Handler::parse_range, so
+// nothing is copied or allocated per line.
+//
+// Blanks around a value are trimmed; everything else must be the
+// value itself, so "45xyz", "12.5.7" or "1e1 junk" are BadValue, never a
+// partial read.
+//
+// A bad line is reported through the error callback and skipped; the
+// rest of the file still loads.
+//
+enum class ConfigError
+{
+    Syntax,         // no '=' or empty name
+    UnknownName,    // name not in registry[]
+    BadValue        // not wholly a value of the type, or validation failed
+};
+
+inline const char* to_string(ConfigError e)
+{
+    switch (e)
+    {
+    case ConfigError::Syntax:      return "syntax error";
+    case ConfigError::UnknownName: return "unknown parameter";
+    case ConfigError::BadValue:    return "bad value";
+    }
+    return "?";
+}
+
+struct ConfigLoadResult
+{
+    bool   opened  = false;
+    size_t lines   = 0;
+    size_t applied = 0;
+    size_t errors  = 0;
+};
+
+namespace detail
+{
+inline bool is_blank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+inline std::string_view trim(const char* first, const char* last)
+{
+    while (first != last && is_blank(*first)) ++first;
+    while (last != first && is_blank(last[-1])) --last;
+    return std::string_view(first, static_cast<size_t>(last - first));
+}
+
+//
+// Read-only private mapping of a whole file. Empty files map to an
+// empty range.
+//
+class MappedFile
+{
+public:
+    explicit MappedFile(const char* path)
+    {
+        fd_ = ::open(path, O_RDONLY | O_CLOEXEC);
+        if (fd_ < 0) return;
+
+        struct stat st{};
+        if (::fstat(fd_, &st) != 0) return;
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ == 0)
+        {
+            ok_ = true;
+            return;
+        }
+
+        void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+        if (p == MAP_FAILED) return;
+        ::madvise(p, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(p);
+        ok_ = true;
+    }
+
+    ~MappedFile()
+    {
+        if (data_) ::munmap(const_cast<char*>(data_), size_);
+        if (fd_ >= 0) ::close(fd_);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool        ok()    const { return ok_; }
+    const char* begin() const { return data_; }
+    const char* end()   const { return data_ + size_; }
+
+private:
+    int         fd_   = -1;
+    const char* data_ = nullptr;
+    size_t      size_ = 0;
+    bool        ok_   = false;
+};
+}
+
+//
+// Load from an in-memory range. on_error is called as
+// on_error(size_t line_number, ConfigError, std::string_view line).
+//
+template <typename OnError>
+ConfigLoadResult load_config(const char* first, const char* last, ParameterTable& table, OnError&& on_error)
+{
+    ConfigLoadResult result;
+    result.opened = true;
+
+    alignas(kMaxParameterAlign) unsigned char value[kMaxParameterSize];
+
+    while (first != last)
+    {
+        const char* eol = static_cast<const char*>(std::memchr(first, '\n', static_cast<size_t>(last - first)));
+        if (!eol) eol = last;
+        const std::string_view line = detail::trim(first, eol);
+        first = eol == last ? last : eol + 1;
+        ++result.lines;
+
+        if (line.empty() || line.front() == '#') continue;
+
+        const size_t eq = line.find('=');
+        const std::string_view name = eq == std::string_view::npos
+            ? std::string_view{}
+            : detail::trim(line.data(), line.data() + eq);
+        if (name.empty())
+        {
+            ++result.errors;
+            on_error(result.lines, ConfigError::Syntax, line);
+            continue;
+        }
+
+        const Handler* h = find_by_name(name);
+        if (!h)
+        {
+            ++result.errors;
+            on_error(result.lines, ConfigError::UnknownName, line);
+            continue;
+        }
+
+        const std::string_view text = detail::trim(line.data() + eq + 1, line.data() + line.size());
+        if (!h->parse_text(text, value))
+        {
+            ++result.errors;
+            on_error(result.lines, ConfigError::BadValue, line);
+            continue;
+        }
+
+        table.set(h->id, value);
+        ++result.applied;
+    }
+    return result;
+}
+
+template <typename OnError>
+ConfigLoadResult load_config_file(const char* path, ParameterTable& table, OnError&& on_error)
+{
+    detail::MappedFile file(path);
+    if (!file.ok()) return ConfigLoadResult{};
+    return load_config(file.begin(), file.end(), table, on_error);
+}
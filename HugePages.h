@@ -0,0 +1,179 @@
+#pragma once
+#include "Platform.h"
+#include "ThreadAffinity.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <utility>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+//
+// Memory for objects on the worker's hot path (rings, tables).
+//
+// Default       - ordinary anonymous pages.
+// HugePreferred - 2 MiB aligned and madvise(MADV_HUGEPAGE), so
+//                 transparent huge pages back it when the kernel has
+//                 them; no setup needed.
+// HugeRequired  - MAP_HUGETLB from the reserved pool
+//                 (vm.nr_hugepages); falls back to HugePreferred if
+//                 none are free, see PageBox::huge().
+//
+// Linux only; elsewhere every option is ordinary aligned new.
+//
+enum class PageBacking
+{
+    Default,
+    HugePreferred,
+    HugeRequired
+};
+
+namespace detail
+{
+constexpr std::size_t kHugePageSize = std::size_t(2) << 20;
+
+constexpr std::size_t round_up(std::size_t n, std::size_t to) { return (n + to - 1) / to * to; }
+
+struct PageMapping
+{
+    void*       base  = nullptr;
+    std::size_t bytes = 0;
+    bool        huge  = false;   // from the hugetlb pool
+};
+
+inline PageMapping map_pages(std::size_t size, PageBacking backing)
+{
+    PageMapping m;
+#if defined(__linux__)
+    if (backing == PageBacking::Default)
+    {
+        m.bytes = size;
+        void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        m.base = p == MAP_FAILED ? nullptr : p;
+        return m;
+    }
+
+    m.bytes = round_up(size, kHugePageSize);
+#if defined(MAP_HUGETLB)
+    if (backing == PageBacking::HugeRequired)
+    {
+        void* p = ::mmap(nullptr, m.bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED)
+        {
+            m.base = p;
+            m.huge = true;
+            return m;
+        }
+    }
+#endif
+    // Over-map by one huge page, then trim to a 2 MiB aligned range so
+    // THP can back it.
+    const std::size_t span = m.bytes + kHugePageSize;
+    void* p = ::mmap(nullptr, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) return PageMapping{};
+    const auto raw     = reinterpret_cast<std::uintptr_t>(p);
+    const auto aligned = round_up(raw, kHugePageSize);
+    if (aligned > raw) ::munmap(p, aligned - raw);
+    if (raw + span > aligned + m.bytes) ::munmap(reinterpret_cast<void*>(aligned + m.bytes), raw + span - aligned - m.bytes);
+    m.base = reinterpret_cast<void*>(aligned);
+#if defined(MADV_HUGEPAGE)
+    ::madvise(m.base, m.bytes, MADV_HUGEPAGE);
+#endif
+#else
+    (void)backing;
+    m.bytes = size;
+    m.base  = ::operator new(size, std::align_val_t(kCacheLineSize), std::nothrow);
+#endif
+    return m;
+}
+
+inline void unmap_pages(const PageMapping& m)
+{
+    if (!m.base) return;
+#if defined(__linux__)
+    ::munmap(m.base, m.bytes);
+#else
+    ::operator delete(m.base, std::align_val_t(kCacheLineSize));
+#endif
+}
+
+//
+// Lock every current and future page of the process into RAM. Returns
+// false without CAP_IPC_LOCK or a large enough RLIMIT_MEMLOCK.
+//
+inline bool lock_all_memory()
+{
+#if defined(__linux__)
+    return ::mlockall(MCL_CURRENT | MCL_FUTURE) == 0;
+#else
+    return false;
+#endif
+}
+}
+
+//
+// Owns one T in memory mapped for it alone. The mapping is zeroed and
+// T constructed on a thread with the given placement, so with the
+// kernel's default first-touch policy every page lands on that thread's
+// NUMA node. Empty (get() == nullptr) if the mapping failed.
+//
+template <typename T>
+class PageBox
+{
+public:
+    PageBox() = default;
+
+    template <typename... Args>
+    PageBox(PageBacking backing, const ThreadPlacement& where, Args&&... args)
+    {
+        static_assert(alignof(T) <= 4096, "PageBox aligns to the page.");
+        detail::run_placed(where, [&]
+        {
+            map_ = detail::map_pages(sizeof(T), backing);
+            if (!map_.base) return;
+            std::memset(map_.base, 0, map_.bytes);
+            obj_ = ::new (map_.base) T(std::forward<Args>(args)...);
+        });
+    }
+
+    ~PageBox() { reset(); }
+
+    PageBox(PageBox&& o) noexcept : map_(std::exchange(o.map_, {})), obj_(std::exchange(o.obj_, nullptr)) {}
+
+    PageBox& operator=(PageBox&& o) noexcept
+    {
+        if (this != &o)
+        {
+            reset();
+            map_ = std::exchange(o.map_, {});
+            obj_ = std::exchange(o.obj_, nullptr);
+        }
+        return *this;
+    }
+
+    PageBox(const PageBox&) = delete;
+    PageBox& operator=(const PageBox&) = delete;
+
+    T* get() const { return obj_; }
+    T& operator*() const { return *obj_; }
+    T* operator->() const { return obj_; }
+    explicit operator bool() const { return obj_ != nullptr; }
+
+    // True if the memory came from the reserved hugetlb pool.
+    bool huge() const { return map_.huge; }
+
+    void reset()
+    {
+        if (obj_) obj_->~T();
+        obj_ = nullptr;
+        detail::unmap_pages(map_);
+        map_ = {};
+    }
+
+private:
+    detail::PageMapping map_;
+    T* obj_ = nullptr;
+};
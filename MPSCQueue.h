@@ -0,0 +1,173 @@
+#pragma once
+#include "Platform.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+//
+// Bounded lock-free MPSC (Multi Producer Single Consumer) queue, after
+// Dmitry Vyukov's bounded MPMC design.
+//
+// Every cell carries a sequence number that says whose turn it is:
+// seq == pos means free for the producer claiming position pos, and
+// seq == pos + 1 means filled for the consumer. Producers claim
+// positions with a CAS on enqueuePos_; the single consumer needs no
+// RMW at all. All CapacityPow2 cells are usable.
+//
+// The interface mirrors SPSCQueue so ParamWorker can run on either.
+//
+template <typename T, std::size_t CapacityPow2>
+class MPSCQueue
+{
+    static_assert((CapacityPow2 & (CapacityPow2 - 1)) == 0, "Capacity must be power of two.");
+
+public:
+    static constexpr std::size_t capacity = CapacityPow2;
+
+    MPSCQueue()
+    {
+        for (std::size_t i = 0; i < CapacityPow2; ++i)
+        {
+            cells_[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool try_push(const T& v) { return try_push(T(v)); }
+
+    bool try_push(T&& v)
+    {
+        std::size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true)
+        {
+            cell = &cells_[pos & mask_];
+            const std::size_t seq = cell->seq.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+            if (diff == 0)
+            {
+                if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            }
+            else if (diff < 0)
+            {
+                return false;   // full: the consumer has not freed this cell yet
+            }
+            else
+            {
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+        cell->data = std::move(v);
+        cell->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    //
+    // Claim a contiguous run of up to n positions with a single CAS and
+    // fill it. Runs from different producers never interleave. Returns
+    // the number of elements pushed.
+    //
+    template <typename InputIt>
+    std::size_t try_push_n(InputIt first, std::size_t n)
+    {
+        return push_run(first, n, false);
+    }
+
+    // All n elements as one contiguous run, or none.
+    template <typename InputIt>
+    bool try_push_all(InputIt first, std::size_t n)
+    {
+        return n == 0 || push_run(first, n, true) == n;
+    }
+
+    std::optional<T> try_pop()
+    {
+        const std::size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+        Cell& cell = cells_[pos & mask_];
+        if (cell.seq.load(std::memory_order_acquire) != pos + 1) return std::nullopt;
+        T v = std::move(cell.data);
+        cell.seq.store(pos + CapacityPow2, std::memory_order_release);
+        dequeuePos_.store(pos + 1, std::memory_order_release);
+        return v;
+    }
+
+    //
+    // Consume up to max elements in FIFO order, stopping at the first
+    // cell a producer has claimed but not yet filled. Cells are handed
+    // back one by one; the consumer position is published once.
+    //
+    template <typename Fn>
+    std::size_t pop_bulk(Fn&& fn, std::size_t max)
+    {
+        const std::size_t start = dequeuePos_.load(std::memory_order_relaxed);
+        std::size_t pos = start;
+        for (; pos - start < max; ++pos)
+        {
+            Cell& cell = cells_[pos & mask_];
+            if (cell.seq.load(std::memory_order_acquire) != pos + 1) break;
+            fn(std::move(cell.data));
+            cell.seq.store(pos + CapacityPow2, std::memory_order_release);
+        }
+        if (pos != start) dequeuePos_.store(pos, std::memory_order_release);
+        return pos - start;
+    }
+
+    // Span flavour of pop_bulk: moves up to max elements into out.
+    std::size_t pop_bulk(T* out, std::size_t max)
+    {
+        return pop_bulk([&out](T&& v) { *out++ = std::move(v); }, max);
+    }
+
+    // Consumer-side check (also what the wait policies poll).
+    bool empty() const
+    {
+        const std::size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+        return cells_[pos & mask_].seq.load(std::memory_order_acquire) != pos + 1;
+    }
+
+    // Claimed positions not yet consumed; includes cells still being filled.
+    std::size_t size_approx() const
+    {
+        const std::size_t enq = enqueuePos_.load(std::memory_order_relaxed);
+        const std::size_t deq = dequeuePos_.load(std::memory_order_relaxed);
+        return enq > deq ? enq - deq : 0;
+    }
+
+private:
+    static constexpr std::size_t mask_ = CapacityPow2 - 1;
+
+    template <typename InputIt>
+    std::size_t push_run(InputIt first, std::size_t n, bool all)
+    {
+        std::size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        std::size_t count;
+        while (true)
+        {
+            // Cells are freed in order, so everything below
+            // dequeuePos_ + capacity is free for the taking.
+            const std::size_t freed = dequeuePos_.load(std::memory_order_acquire) + CapacityPow2;
+            const std::size_t free = freed > pos ? freed - pos : 0;
+            count = n < free ? n : free;
+            if (count == 0 || (all && count < n)) return 0;
+            if (enqueuePos_.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed)) break;
+        }
+        for (std::size_t i = 0; i < count; ++i, ++first)
+        {
+            Cell& cell = cells_[(pos + i) & mask_];
+            cell.data = *first;
+            cell.seq.store(pos + i + 1, std::memory_order_release);
+        }
+        return count;
+    }
+
+    struct Cell
+    {
+        std::atomic<std::size_t> seq;
+        T data{};
+    };
+
+    alignas(kCacheLineSize) Cell cells_[CapacityPow2];
+    alignas(kCacheLineSize) std::atomic<std::size_t> enqueuePos_{0};
+    alignas(kCacheLineSize) std::atomic<std::size_t> dequeuePos_{0};
+};
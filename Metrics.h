@@ -0,0 +1,247 @@
+#pragma once
+#include "ParameterTraits.h"
+#include "Platform.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+//
+// Opt-in hot-path instrumentation, enabled with PARAMETER_TRAITS_METRICS=1
+// (CMake option of the same name).
+//
+// With metrics off, WorkerMetrics keeps its interface but every recording
+// call is an empty inline and Msg carries no timestamp, so instrumented
+// code compiles to exactly what it was before.
+//
+#ifndef PARAMETER_TRAITS_METRICS
+#define PARAMETER_TRAITS_METRICS 0
+#endif
+
+namespace detail
+{
+inline uint64_t metrics_now_ns()
+{
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+//
+// HDR-style bucketing: values below 2^kSubBits get a bucket each, above
+// that every power of two is split into 2^kSubBits linear sub-buckets,
+// so the relative error stays under 1/2^kSubBits over the whole range.
+//
+struct LatencyBuckets
+{
+    static constexpr unsigned    kSubBits = 2;
+    static constexpr std::size_t kSub     = std::size_t(1) << kSubBits;
+    static constexpr std::size_t kCount   = (64 - kSubBits + 1) * kSub;
+
+    static constexpr std::size_t index(uint64_t v)
+    {
+        if (v < kSub) return static_cast<std::size_t>(v);
+        unsigned msb = 63;
+        while (!(v >> msb)) --msb;
+        const unsigned shift = msb - kSubBits;
+        return ((shift + 1) << kSubBits) + static_cast<std::size_t>((v >> shift) & (kSub - 1));
+    }
+
+    // Smallest value that lands in bucket i.
+    static constexpr uint64_t lower_bound(std::size_t i)
+    {
+        if (i < kSub) return i;
+        const unsigned shift = static_cast<unsigned>(i >> kSubBits) - 1;
+        return (uint64_t(kSub) | (i & (kSub - 1))) << shift;
+    }
+};
+
+static_assert(LatencyBuckets::index(LatencyBuckets::lower_bound(37)) == 37);
+static_assert(LatencyBuckets::index(~uint64_t(0)) == LatencyBuckets::kCount - 1);
+
+// A counter written by one thread and read by anyone. Increments are a
+// relaxed load and store, not an RMW.
+class OwnedCounter
+{
+public:
+    void add(uint64_t n = 1) { v_.store(v_.load(std::memory_order_relaxed) + n, std::memory_order_relaxed); }
+    void raise_to(uint64_t n)
+    {
+        if (n > v_.load(std::memory_order_relaxed)) v_.store(n, std::memory_order_relaxed);
+    }
+    uint64_t load() const { return v_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> v_{0};
+};
+}
+
+//
+// Plain copy of all counters, taken on demand with WorkerMetrics::snapshot().
+//
+struct MetricsSnapshot
+{
+    std::array<uint64_t, registryCount> applied{};
+    std::array<uint64_t, registryCount> rejected{};
+    uint64_t unknown       = 0;   // messages with an unregistered id
+    uint64_t pushed        = 0;   // messages enqueued, transaction and ticket markers included
+    uint64_t push_fail     = 0;   // post calls that found the queue full, once per call
+    uint64_t high_water    = 0;   // deepest queue seen at the start of a drain
+    uint64_t store_errors  = 0;   // ParamStore appends and commits that failed
+    uint64_t blob_rejected = 0;   // SetBlob values not stored
+    std::array<uint64_t, detail::LatencyBuckets::kCount> latency{};   // enqueue -> handled, ns
+
+    uint64_t latency_count() const
+    {
+        uint64_t n = 0;
+        for (auto c : latency) n += c;
+        return n;
+    }
+
+    // Lower bound of the bucket holding quantile q (0..1), in ns.
+    uint64_t latency_quantile(double q) const
+    {
+        const uint64_t total = latency_count();
+        if (total == 0) return 0;
+        const auto want = static_cast<uint64_t>(q * double(total - 1)) + 1;
+        uint64_t seen = 0;
+        for (std::size_t i = 0; i < latency.size(); ++i)
+        {
+            seen += latency[i];
+            if (seen >= want) return detail::LatencyBuckets::lower_bound(i);
+        }
+        return 0;
+    }
+};
+
+inline std::ostream& operator<<(std::ostream& os, const MetricsSnapshot& s)
+{
+    os << "[Metrics] pushed=" << s.pushed << " push_fail=" << s.push_fail
+       << " high_water=" << s.high_water << " unknown=" << s.unknown
+       << " store_errors=" << s.store_errors << " blob_rejected=" << s.blob_rejected << "\n";
+    for (auto const& h : registry)
+    {
+        const auto i = static_cast<std::size_t>(h.id);
+        os << "[Metrics] " << h.name << " applied=" << s.applied[i] << " rejected=" << s.rejected[i] << "\n";
+    }
+    os << "[Metrics] latency_ns n=" << s.latency_count() << " p50>=" << s.latency_quantile(0.50)
+       << " p99>=" << s.latency_quantile(0.99) << " max>=" << s.latency_quantile(1.0) << "\n";
+    return os;
+}
+
+#if PARAMETER_TRAITS_METRICS
+
+//
+// Counters for one ParamWorker. Worker-side counters sit together on
+// their own cache lines; producers get one padded slot per thread
+// (threads beyond kProducerSlots share slots round-robin), so a producer
+// bumping its push count never touches a line the worker writes.
+//
+class WorkerMetrics
+{
+public:
+    static constexpr bool enabled = true;
+    static constexpr std::size_t kProducerSlots = 16;
+
+    // Producer side.
+    void on_push(bool ok)
+    {
+        Producer& p = producers_[producer_slot()];
+        (ok ? p.pushed : p.push_fail).fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // pushed messages went in; failed != 0 if the call was left short.
+    void on_push_n(std::size_t pushed, std::size_t failed)
+    {
+        Producer& p = producers_[producer_slot()];
+        if (pushed) p.pushed.fetch_add(pushed, std::memory_order_relaxed);
+        if (failed) p.push_fail.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Worker side.
+    void on_queue_depth(std::size_t depth) { worker_.high_water.raise_to(depth); }
+    void on_unknown() { worker_.unknown.add(); }
+    void on_store_error() { worker_.store_errors.add(); }
+    void on_blob_rejected() { worker_.blob_rejected.add(); }
+    void on_applied(ParameterID id) { worker_.applied[static_cast<std::size_t>(id)].add(); }
+    void on_rejected(ParameterID id) { worker_.rejected[static_cast<std::size_t>(id)].add(); }
+    void on_handled(uint64_t enqueue_ns)
+    {
+        const uint64_t now = detail::metrics_now_ns();
+        worker_.latency[detail::LatencyBuckets::index(now > enqueue_ns ? now - enqueue_ns : 0)].add();
+    }
+
+    // Safe from any thread; each counter is individually consistent.
+    MetricsSnapshot snapshot() const
+    {
+        MetricsSnapshot s;
+        for (std::size_t i = 0; i < registryCount; ++i)
+        {
+            s.applied[i]  = worker_.applied[i].load();
+            s.rejected[i] = worker_.rejected[i].load();
+        }
+        s.unknown    = worker_.unknown.load();
+        s.high_water = worker_.high_water.load();
+        s.store_errors = worker_.store_errors.load();
+        s.blob_rejected = worker_.blob_rejected.load();
+        for (std::size_t i = 0; i < s.latency.size(); ++i) s.latency[i] = worker_.latency[i].load();
+        for (auto const& p : producers_)
+        {
+            s.pushed    += p.pushed.load(std::memory_order_relaxed);
+            s.push_fail += p.push_fail.load(std::memory_order_relaxed);
+        }
+        return s;
+    }
+
+private:
+    struct alignas(kCacheLineSize) Producer
+    {
+        std::atomic<uint64_t> pushed{0};
+        std::atomic<uint64_t> push_fail{0};
+    };
+
+    struct alignas(kCacheLineSize) Worker
+    {
+        std::array<detail::OwnedCounter, registryCount> applied;
+        std::array<detail::OwnedCounter, registryCount> rejected;
+        detail::OwnedCounter unknown;
+        detail::OwnedCounter high_water;
+        detail::OwnedCounter store_errors;
+        detail::OwnedCounter blob_rejected;
+        std::array<detail::OwnedCounter, detail::LatencyBuckets::kCount> latency;
+    };
+
+    static std::size_t producer_slot()
+    {
+        static std::atomic<std::size_t> next{0};
+        thread_local const std::size_t slot = next.fetch_add(1, std::memory_order_relaxed) % kProducerSlots;
+        return slot;
+    }
+
+    std::array<Producer, kProducerSlots> producers_;
+    Worker worker_;
+};
+
+#else
+
+class WorkerMetrics
+{
+public:
+    static constexpr bool enabled = false;
+
+    void on_push(bool) {}
+    void on_push_n(std::size_t, std::size_t) {}
+    void on_queue_depth(std::size_t) {}
+    void on_unknown() {}
+    void on_store_error() {}
+    void on_blob_rejected() {}
+    void on_applied(ParameterID) {}
+    void on_rejected(ParameterID) {}
+    void on_handled(uint64_t) {}
+
+    MetricsSnapshot snapshot() const { return {}; }
+};
+
+#endif
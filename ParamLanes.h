@@ -0,0 +1,283 @@
+#pragma once
+#include "ParameterTraits.h"
+#include "ParamMessage.h"
+#include "Metrics.h"
+#include "SPSCQueue.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+//
+// How ParamLanes shares each drain between its lanes.
+//
+// Strict   - a lane is only drained once every more urgent lane is
+//            empty. Critical latency is one batch at most; Bulk can
+//            starve under sustained Normal load.
+// Weighted - each lane first gets a share of the batch in proportion to
+//            its weight, always taken in priority order, and whatever
+//            is left goes to the most urgent lanes with work. Critical
+//            still goes first; no lane starves.
+//
+// Either way a run (a transaction, or a ticket and its update) is
+// never cut: a drain that reaches into one finishes it before taking
+// anything from another lane, so pop_bulk may return a little more
+// than max.
+//
+enum class LaneSchedule
+{
+    Strict,
+    Weighted
+};
+
+//
+// One ring per Lane behind the queue interface ParamWorker expects
+// (try_push, try_push_n, try_push_all, pop_bulk, empty, size_approx),
+// so a worker over ParamLanes gets priority lanes with no other change:
+//
+//   ParamLanes<> lanes;
+//   ParamWorker<ParamLanes<>> worker(lanes, table);
+//
+// Updates go to their parameter's ParameterTraits<T>::lane, blobs to
+// Bulk, and a transaction (or a ticketed update) to the most urgent
+// lane of its members; a run is never split.
+//
+// Order is kept per parameter. A parameter's standalone updates always
+// share a lane. A transaction whose members span lanes is fenced in
+// both directions: a Fence ahead of it in its own lane makes the drain
+// first take everything pushed earlier to each less urgent member lane,
+// and a Fence pushed to each of those lanes right after it stops their
+// drain from passing that point until the transaction is delivered.
+// Such a transaction waits for its slowest member lane's backlog, and
+// that lane's later updates wait for the transaction.
+//
+// Fences count pushes, so ParamLanes takes a single producer, as its
+// default SPSC lanes do anyway.
+//
+// Stop does not take a lane: it is flagged and delivered once every
+// lane has drained, so nothing queued before it is dropped.
+//
+// Messages with a deadline_us that has passed by the time they are
+// drained are counted per lane in missed(); they are still applied.
+//
+template <typename Queue = SPSCQueue<Msg, 1024, QueueLayout::CacheAligned>>
+class ParamLanes
+{
+public:
+    using Weights = std::array<unsigned, kLaneCount>;
+
+    explicit ParamLanes(LaneSchedule schedule = LaneSchedule::Strict, Weights weights = { 8, 4, 1 })
+        : schedule_(schedule), weights_(weights)
+    {
+        for (auto w : weights_) weightSum_ += w;
+    }
+
+    static Lane lane_of(const Msg& m)
+    {
+        if (m.kind == MsgKind::SetBlob) return Lane::Bulk;
+        const Handler* h = find_by_id(m.id);
+        return h ? h->lane : Lane::Normal;
+    }
+
+    bool try_push(const Msg& m)
+    {
+        if (m.kind == MsgKind::Stop)
+        {
+            stop_.store(true, std::memory_order_release);
+            return true;
+        }
+        return push(index(lane_of(m)), m);
+    }
+
+    // In order, stopping at the first message whose lane is full.
+    template <typename InputIt>
+    std::size_t try_push_n(InputIt first, std::size_t n)
+    {
+        std::size_t i = 0;
+        for (; i < n && try_push(*first); ++i, ++first) {}
+        return i;
+    }
+
+    // A contiguous run (a transaction) in one lane, all or nothing.
+    bool try_push_all(const Msg* first, std::size_t n)
+    {
+        if (n == 0) return true;
+        std::array<bool, kLaneCount> member{};
+        std::size_t l = kLaneCount - 1;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            if (first[i].kind == MsgKind::TxnBegin || first[i].kind == MsgKind::Ticket) continue;
+            const std::size_t li = index(lane_of(first[i]));
+            member[li] = true;
+            if (li < l) l = li;
+        }
+
+        // Room is checked up front: with one producer it can only grow,
+        // so once the first fence is in, nothing below can fail.
+        std::size_t fences = 0;
+        for (std::size_t o = l + 1; o < kLaneCount; ++o)
+        {
+            if (!member[o]) continue;
+            if (room(o) == 0) return false;
+            ++fences;
+        }
+        if (room(l) < fences + n) return false;
+
+        for (std::size_t o = l + 1; o < kLaneCount; ++o)
+            if (member[o]) push(l, fence(o, pushed_[o]));
+        lanes_[l].try_push_all(first, n);
+        pushed_[l] += static_cast<uint32_t>(n);
+        for (std::size_t o = l + 1; o < kLaneCount; ++o)
+            if (member[o]) push(o, fence(l, pushed_[l]));
+        return true;
+    }
+
+    template <typename Fn>
+    std::size_t pop_bulk(Fn&& fn, std::size_t max)
+    {
+        DrainState<Fn> d{ fn };
+
+        if (schedule_ == LaneSchedule::Weighted && weightSum_)
+        {
+            for (std::size_t l = 0; l < kLaneCount && d.got < max; ++l)
+            {
+                const std::size_t share = max * weights_[l] / weightSum_;
+                drain(l, share ? share : 1, d);
+            }
+        }
+        for (std::size_t l = 0; l < kLaneCount && d.got < max; ++l) drain(l, max - d.got, d);
+
+        // Seen after everything queued before it, in any lane.
+        if (d.got < max && stop_.load(std::memory_order_acquire) && lanes_empty())
+        {
+            stop_.store(false, std::memory_order_relaxed);
+            fn(Msg{ Stop{} });
+            ++d.got;
+        }
+        return d.got;
+    }
+
+    bool empty() const { return !stop_.load(std::memory_order_acquire) && lanes_empty(); }
+
+    std::size_t size_approx() const
+    {
+        std::size_t n = 0;
+        for (auto const& q : lanes_) n += q.size_approx();
+        return n;
+    }
+
+    std::size_t size_approx(Lane l) const { return lanes_[static_cast<std::size_t>(l)].size_approx(); }
+
+    // Messages drained from lane l after their deadline.
+    uint64_t missed(Lane l) const { return missed_[static_cast<std::size_t>(l)].load(); }
+
+private:
+    template <typename Fn>
+    struct DrainState
+    {
+        Fn&         fn;
+        std::size_t got     = 0;   // delivered to fn
+        bool        haveNow = false;
+        uint32_t    now     = 0;
+    };
+
+    static std::size_t index(Lane l) { return static_cast<std::size_t>(l); }
+
+    // Lane to catch up (in id) and its push count (in the payload).
+    static Msg fence(std::size_t l, uint32_t pushed)
+    {
+        static_assert(kMaxParameterSize >= sizeof(uint32_t), "Fence count must fit the payload.");
+        Msg m;
+        m.kind = MsgKind::Fence;
+        m.id   = static_cast<ParameterID>(l);
+        std::memcpy(m.payload, &pushed, sizeof(pushed));
+        return m;
+    }
+
+    bool push(std::size_t l, const Msg& m)
+    {
+        if (!lanes_[l].try_push(m)) return false;
+        ++pushed_[l];
+        return true;
+    }
+
+    // Producer side: free slots in lane l, never more than there are.
+    std::size_t room(std::size_t l) const { return Queue::capacity - lanes_[l].size_approx(); }
+
+    //
+    // Pop up to want messages from lane l, then the rest of any run that
+    // cut into. Returns how many were popped, fences included.
+    //
+    template <typename Fn>
+    std::size_t drain(std::size_t l, std::size_t want, DrainState<Fn>& d)
+    {
+        auto take = [&](Msg&& m) { deliver(l, std::move(m), d); };
+        std::size_t n = lanes_[l].pop_bulk(take, want);
+        while (open_[l])
+        {
+            // A run is pushed whole, so the rest is already there.
+            const std::size_t more = lanes_[l].pop_bulk(take, open_[l]);
+            if (more == 0) std::this_thread::yield();
+            n += more;
+        }
+        return n;
+    }
+
+    template <typename Fn>
+    void deliver(std::size_t l, Msg&& m, DrainState<Fn>& d)
+    {
+        ++popped_[l];
+        if (open_[l]) --open_[l];
+        else if (m.kind == MsgKind::TxnBegin) open_[l] = m.txn_count();
+        else if (m.kind == MsgKind::Ticket) open_[l] = 1;
+
+        if (m.kind == MsgKind::Fence)
+        {
+            // Catch lane o up to the count. It never needs lane l itself:
+            // everything l's fences wait for was pushed before them.
+            uint32_t upto;
+            std::memcpy(&upto, m.payload, sizeof(upto));
+            const auto o = static_cast<std::size_t>(m.id);
+            while (static_cast<int32_t>(upto - popped_[o]) > 0)
+            {
+                if (drain(o, upto - popped_[o], d) == 0) std::this_thread::yield();
+            }
+            return;
+        }
+
+        if (m.deadline_us)
+        {
+            if (!d.haveNow)
+            {
+                d.now = detail::deadline_clock_us();
+                d.haveNow = true;
+            }
+            if (past_deadline(m, d.now)) missed_[l].add();
+        }
+        d.fn(std::move(m));
+        ++d.got;
+    }
+
+    bool lanes_empty() const
+    {
+        for (auto const& q : lanes_)
+            if (!q.empty()) return false;
+        return true;
+    }
+
+    std::array<Queue, kLaneCount> lanes_;
+    LaneSchedule schedule_;
+    Weights weights_;
+    unsigned weightSum_ = 0;
+    alignas(kCacheLineSize) std::atomic<bool> stop_{false};
+    std::array<detail::OwnedCounter, kLaneCount> missed_{};
+
+    // Messages pushed (producer only) and popped (worker only) per lane;
+    // a Fence carries the first and is compared with the second,
+    // wrap-safe.
+    alignas(kCacheLineSize) std::array<uint32_t, kLaneCount> pushed_{};
+    alignas(kCacheLineSize) std::array<uint32_t, kLaneCount> popped_{};
+    std::array<std::size_t, kLaneCount> open_{};   // members left of the run being drained
+};
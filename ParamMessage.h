@@ -0,0 +1,186 @@
+#pragma once
+#include "Metrics.h"
+#include "ParameterTraits.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+
+//
+// Message "constructors" (carry full tag types at the call site)
+//
+struct Stop {};
+
+// Opens a Transaction of count SetParams (see Transaction.h).
+struct TxnBegin
+{
+    uint16_t count = 0;
+};
+
+// Asks for the outcome of the message right behind it (see AsyncParams.h).
+struct Ticket
+{
+    uint32_t id = 0;
+};
+
+template <typename ParamTag>
+struct SetParam
+{
+    ParamTag value{};
+};
+
+//
+// A SetParam whose value was checked at compile time. The worker skips
+// validate() for it (cross-parameter rules still run). The only way to
+// get one is prove_valid(); wrap it in PARAMETER_TRAITS_TRUSTED so the
+// check happens during compilation:
+//
+//   constexpr TemperatureSetpoint kRecipeSetpoint{ 42.0f };
+//   worker.try_post(PARAMETER_TRAITS_TRUSTED(kRecipeSetpoint));
+//
+// An out-of-range constant then fails to compile.
+//
+template <typename Tag>
+class TrustedSetParam;
+
+template <typename Tag>
+constexpr TrustedSetParam<Tag> prove_valid(Tag value);
+
+template <typename Tag>
+class TrustedSetParam
+{
+public:
+    constexpr const Tag& value() const { return value_; }
+
+private:
+    constexpr explicit TrustedSetParam(const Tag& v) : value_(v) {}
+    friend constexpr TrustedSetParam prove_valid<Tag>(Tag);
+
+    Tag value_;
+};
+
+namespace detail
+{
+// Deliberately not constexpr: reaching it during constant evaluation is
+// what turns an invalid constant into a compile error.
+[[noreturn]] inline void trusted_value_out_of_range() { std::abort(); }
+}
+
+// Outside a constant expression an invalid value aborts.
+template <typename Tag>
+constexpr TrustedSetParam<Tag> prove_valid(Tag value)
+{
+    if (!param_validate(value)) detail::trusted_value_out_of_range();
+    return TrustedSetParam<Tag>(value);
+}
+
+#define PARAMETER_TRAITS_TRUSTED(...) \
+    ([] { constexpr auto proven_ = ::prove_valid(__VA_ARGS__); return proven_; }())
+
+enum class MsgKind : uint8_t
+{
+    SetParam,
+    Stop,
+    Conflated,  // value is in the worker's ConflationSlots, not the payload
+    TxnBegin,   // payload holds the uint16 update count
+    SetTrusted, // SetParam proven valid at compile time
+    SetBlob,    // id is a BlobID, payload a PayloadHandle (see PayloadPool.h)
+    Ticket,     // payload holds the uint32 ticket for the next message
+    Fence       // ParamLanes only; never reaches a worker
+};
+
+//
+// Type-erased, fixed-size message. Instead of a std::variant with one
+// alternative per parameter, a Msg is a ParameterID plus the raw bytes
+// of the value, sized to the largest registered parameter. The worker
+// dispatches through the registry[] Handler for that id, so adding a
+// parameter does not grow the message or a visit() jump table.
+//
+struct Msg
+{
+    alignas(kMaxParameterAlign) unsigned char payload[kMaxParameterSize]{};
+    ParameterID id{};
+    MsgKind     kind{MsgKind::Stop};
+    uint32_t    deadline_us = 0;  // 0 = none; see with_deadline()
+#if PARAMETER_TRAITS_METRICS
+    uint64_t    enqueue_ns = 0;   // stamped by ParamWorker::try_post
+#endif
+
+    constexpr Msg() = default;
+
+    constexpr Msg(Stop) : kind(MsgKind::Stop) {}
+
+    Msg(TxnBegin t) : kind(MsgKind::TxnBegin)
+    {
+        static_assert(kMaxParameterSize >= sizeof(uint16_t), "TxnBegin count must fit the payload.");
+        std::memcpy(payload, &t.count, sizeof(t.count));
+    }
+
+    Msg(Ticket t) : kind(MsgKind::Ticket)
+    {
+        static_assert(kMaxParameterSize >= sizeof(uint32_t), "Ticket must fit the payload.");
+        std::memcpy(payload, &t.id, sizeof(t.id));
+    }
+
+    template <typename Tag>
+    Msg(const TrustedSetParam<Tag>& s) : Msg(SetParam<Tag>{ s.value() })
+    {
+        kind = MsgKind::SetTrusted;
+    }
+
+    uint16_t txn_count() const
+    {
+        uint16_t n;
+        std::memcpy(&n, payload, sizeof(n));
+        return n;
+    }
+
+    uint32_t ticket() const
+    {
+        uint32_t t;
+        std::memcpy(&t, payload, sizeof(t));
+        return t;
+    }
+
+    template <typename Tag>
+    Msg(const SetParam<Tag>& s) : id(param_id<Tag>()), kind(MsgKind::SetParam)
+    {
+        static_assert(std::is_trivially_copyable_v<Tag>, "Parameter types travel as raw bytes.");
+        static_assert(sizeof(Tag) <= kMaxParameterSize && alignof(Tag) <= kMaxParameterAlign,
+                      "Parameter type missing from registry[].");
+        std::memcpy(payload, &s.value, sizeof(Tag));
+    }
+};
+
+static_assert(sizeof(Msg) <= (PARAMETER_TRAITS_METRICS ? 24 : 16),
+              "Msg should stay small enough to pack several per cache line.");
+
+//
+// Deadlines are microseconds on the steady clock, truncated to 32 bits
+// so they fit next to the payload. Comparisons are wrap-safe for
+// deadlines within about half an hour of now, far beyond any queue
+// delay worth tracking.
+//
+namespace detail
+{
+inline uint32_t deadline_clock_us()
+{
+    return static_cast<uint32_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+}
+
+// m, due to be handled within the given time from now.
+inline Msg with_deadline(Msg m, std::chrono::microseconds within)
+{
+    const uint32_t d = detail::deadline_clock_us() + static_cast<uint32_t>(within.count());
+    m.deadline_us = d ? d : 1;
+    return m;
+}
+
+inline bool past_deadline(const Msg& m, uint32_t now_us)
+{
+    return m.deadline_us && static_cast<int32_t>(now_us - m.deadline_us) > 0;
+}
@@ -0,0 +1,210 @@
+#pragma once
+#include "ParameterTraits.h"
+#include "ParamMessage.h"
+#include "ParameterTable.h"
+#include "HugePages.h"
+#include "ParamWorker.h"
+#include "ThreadAffinity.h"
+#include <array>
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <thread>
+
+//
+// N ParamWorkers, each owning one shard of the parameters. A ParameterID
+// always hashes to the same shard, so per-parameter ordering holds and
+// no two threads ever write the same parameter; shards share nothing.
+//
+// Each shard keeps a full ParameterTable but only writes the entries it
+// owns; collect() merges them once the pool is stopped. WorkerConfig is
+// per shard. Everything a worker writes from its own thread must be
+// per shard too: snapshot, store, metrics, rejects (an SPSC ring),
+// conflation, blobs and completions (also SPSC). The pool throws
+// std::invalid_argument if two shards share one. The payload pool may
+// be shared, and so may subscription tables if their callbacks are
+// thread-safe.
+//
+// A shard checks cross-parameter rules against its own table, so every
+// parameter the rules read (CrossRuleTable::reads()) must hash to one
+// shard; the pool throws std::invalid_argument otherwise, or if the
+// rules declare no parameters at all. Only that shard keeps the rules;
+// updates owned by other shards cannot affect them. Add every rule
+// before building the pool.
+//
+template <std::size_t Shards, typename Queue = ParamMPSCQueue, typename WaitPolicy = DefaultWaitPolicy>
+class ParamPool
+{
+    static_assert(Shards > 0, "A pool needs at least one shard.");
+
+public:
+    using Worker = ParamWorker<Queue, WaitPolicy>;
+
+    static constexpr std::size_t shards = Shards;
+
+    static constexpr std::size_t shard_of(ParameterID id)
+    {
+        return detail::mix32(static_cast<uint32_t>(id)) % Shards;
+    }
+
+    //
+    // Each shard (queue, table and worker) gets its own mapping, backed
+    // as WorkerConfig::pages asks, and is built on a thread placed like
+    // its worker, so with NUMA placement its pages land on the worker's
+    // node.
+    //
+    explicit ParamPool(const std::array<WorkerConfig, Shards>& cfg = {})
+    {
+        for (std::size_t i = 0; i < Shards; ++i)
+        {
+            for (std::size_t j = i + 1; j < Shards; ++j)
+            {
+                if (shares_worker_sink(cfg[i], cfg[j]))
+                    throw std::invalid_argument("Single-writer WorkerConfig sinks must be per shard.");
+            }
+        }
+        for (std::size_t i = 0; i < Shards; ++i)
+        {
+            WorkerConfig c = cfg[i];
+            if (c.rules && !c.rules->empty() && rules_shard(*c.rules) != i) c.rules = nullptr;
+            shards_[i] = PageBox<Shard>(c.pages, c.placement, c);
+            if (!shards_[i]) throw std::bad_alloc();
+        }
+    }
+
+    //
+    // Same worker settings for every shard, threads spread as requested.
+    // The single-writer sinks listed above are left unset; give each
+    // shard its own afterwards.
+    //
+    static std::array<WorkerConfig, Shards> spread(PlacementSpread how, WorkerConfig base = {})
+    {
+        base.snapshot    = nullptr;
+        base.store       = nullptr;
+        base.metrics     = nullptr;
+        base.rejects     = nullptr;
+        base.conflation  = nullptr;
+        base.blobs       = nullptr;
+        base.completions = nullptr;
+
+        std::array<WorkerConfig, Shards> cfg;
+        for (std::size_t i = 0; i < Shards; ++i)
+        {
+            cfg[i] = base;
+            cfg[i].placement = spread_placement(i, how);
+        }
+        return cfg;
+    }
+
+    void start()
+    {
+        for (auto& s : shards_) s->worker.start();
+    }
+
+    // Deliver Stop to every shard (waiting for room if needed) and join.
+    void stop()
+    {
+        for (auto& s : shards_)
+        {
+            while (!s->worker.try_post(Msg{ Stop{} })) std::this_thread::yield();
+        }
+        for (auto& s : shards_) s->worker.join();
+    }
+
+    // Copy every parameter from the shard that owns it. Call after stop().
+    void collect(ParameterTable& out) const
+    {
+        for (auto const& h : registry) out.set(h.id, shards_[shard_of(h.id)]->table.get(h.id));
+    }
+
+    Worker& worker(std::size_t shard) { return shards_[shard]->worker; }
+    const ParameterTable& table(std::size_t shard) const { return shards_[shard]->table; }
+
+    // Whether shard's memory came from the reserved hugetlb pool.
+    bool huge_pages(std::size_t shard) const { return shards_[shard].huge(); }
+
+private:
+    // The one shard owning every parameter the rules read.
+    static std::size_t rules_shard(const CrossRuleTable& rules)
+    {
+        std::size_t shard = Shards;
+        bool spans = false;
+        rules.reads().for_each([&](ParameterID id)
+        {
+            const std::size_t s = shard_of(id);
+            if (shard == Shards) shard = s;
+            else if (s != shard) spans = true;
+        });
+        if (shard == Shards) throw std::invalid_argument("Cross-parameter rules declare no parameters they read.");
+        if (spans) throw std::invalid_argument("Cross-parameter rules read parameters owned by different shards.");
+        return shard;
+    }
+
+    // Whether a and b share something only one worker may write.
+    static bool shares_worker_sink(const WorkerConfig& a, const WorkerConfig& b)
+    {
+        auto same = [](const void* x, const void* y) { return x && x == y; };
+        return same(a.snapshot, b.snapshot) || same(a.store, b.store) || same(a.metrics, b.metrics)
+            || same(a.rejects, b.rejects) || same(a.conflation, b.conflation) || same(a.blobs, b.blobs)
+            || same(a.completions, b.completions);
+    }
+
+    struct Shard
+    {
+        explicit Shard(const WorkerConfig& cfg) : worker(queue, table, cfg) {}
+
+        Queue          queue;
+        ParameterTable table;
+        Worker         worker;
+    };
+
+    std::array<PageBox<Shard>, Shards> shards_;
+};
+
+//
+// Producer-side handle for a ParamPool, used in place of posting to a
+// single worker. It has the same try_post(const Msg&) shape as
+// ParamWorker, so it can sit under a ParamProducer. With the default
+// MPSC shard queues any number of threads may share one router.
+//
+// An AsyncParamClient cannot sit on a router: completions come back
+// per shard. Use one client per shard, on worker(i) with that shard's
+// own CompletionRing, for the parameters shard_of() maps there.
+//
+template <typename Pool>
+class ParamRouter
+{
+public:
+    explicit ParamRouter(Pool& pool) : pool_(pool) {}
+
+    // A Stop goes to every shard; false if any shard was full (shards
+    // that accepted it stay stopped, so prefer Pool::stop()).
+    bool try_post(const Msg& m)
+    {
+        if (m.kind == MsgKind::Stop)
+        {
+            bool ok = true;
+            for (std::size_t i = 0; i < Pool::shards; ++i) ok &= pool_.worker(i).try_post(m);
+            return ok;
+        }
+        return pool_.worker(Pool::shard_of(m.id)).try_post(m);
+    }
+
+    // A transaction is only atomic within one shard; one that spans
+    // shards is refused (as are rules that would need one, see
+    // ParamPool).
+    template <std::size_t N>
+    bool try_post(const Transaction<N>& t)
+    {
+        if (t.updates() == 0) return true;
+        const std::size_t shard = Pool::shard_of(t.data()[1].id);
+        for (std::size_t i = 2; i < t.size(); ++i)
+        {
+            if (Pool::shard_of(t.data()[i].id) != shard) return false;
+        }
+        return pool_.worker(shard).try_post(t);
+    }
+
+private:
+    Pool& pool_;
+};
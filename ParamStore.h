@@ -0,0 +1,402 @@
+#pragma once
+#include "ParameterTraits.h"
+#include "ParameterTable.h"
+#include "ConfigLoader.h"
+#include "WireFormat.h"
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//
+// Persistent parameter store: a binary snapshot of the whole table plus
+// an append-only journal of the SetParams applied since.
+//
+// Snapshot: [uint32 magic "PTSN"][uint16 version][uint16 0][uint32 checksum]
+//           [uint32 0][uint64 epoch] followed by one encode_table() frame.
+//           Replaced atomically (write temp, fsync, rename, fsync dir).
+//
+// Journal:  [uint32 magic "PTJN"][uint16 version][uint16 0][uint64 epoch],
+//           then one block per committed worker batch:
+//           [uint32 magic "PTJB"][uint16 records][uint16 flags][uint32 bytes]
+//           [uint32 checksum] followed by that many wire records.
+//           A transaction too large for the current block spills into
+//           the next; blocks that end inside one carry kBlockContinues,
+//           and replay applies the transaction once its last block is
+//           read, or not at all.
+//
+// A journal only belongs to the snapshot with the same epoch. A
+// checkpoint writes snapshot epoch N+1 before starting journal N+1, so a
+// crash in between leaves an old journal that is simply ignored. Replay
+// stops at the first torn or corrupt block and the journal is cut back
+// to there before new blocks are appended. Checksums are FNV-1a.
+//
+constexpr uint32_t kSnapshotMagic     = 0x4E535450u;  // "PTSN"
+constexpr uint32_t kJournalMagic      = 0x4E4A5450u;  // "PTJN"
+constexpr uint32_t kJournalBlockMagic = 0x424A5450u;  // "PTJB"
+constexpr uint16_t kStoreVersion      = 1;
+
+constexpr uint16_t kBlockContinues    = 1;  // journal block flag
+
+constexpr size_t kSnapshotHeaderSize     = 24;
+constexpr size_t kJournalHeaderSize      = 16;
+constexpr size_t kJournalBlockHeaderSize = 16;
+
+namespace detail
+{
+constexpr size_t max_wire_size()
+{
+    size_t n = 0;
+    for (auto const& h : registry) n = h.wire_size > n ? h.wire_size : n;
+    return n;
+}
+
+inline uint32_t checksum(const unsigned char* p, size_t n)
+{
+    return fnv1a(std::string_view(reinterpret_cast<const char*>(p), n));
+}
+
+inline bool write_all(int fd, const unsigned char* p, size_t n)
+{
+    while (n)
+    {
+        const ssize_t w = ::write(fd, p, n);
+        if (w < 0)
+        {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        p += w;
+        n -= static_cast<size_t>(w);
+    }
+    return true;
+}
+
+// Make a rename in path's directory durable.
+inline bool sync_parent_dir(const std::string& path)
+{
+    const size_t slash = path.find_last_of('/');
+    const std::string dir = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+    const int fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) return false;
+    const bool ok = ::fsync(fd) == 0;
+    ::close(fd);
+    return ok;
+}
+
+// Write a complete file under a temporary name, sync it, rename it over
+// path and sync the directory, so a crash leaves either file whole.
+inline bool replace_file(const std::string& path, const unsigned char* p, size_t n)
+{
+    const std::string tmp = path + ".tmp";
+    const int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) return false;
+    const bool ok = write_all(fd, p, n) && ::fsync(fd) == 0;
+    ::close(fd);
+    return ok && ::rename(tmp.c_str(), path.c_str()) == 0 && sync_parent_dir(path);
+}
+}
+
+struct StoreOpenResult
+{
+    bool   snapshot = false;   // a valid snapshot was loaded
+    size_t blocks   = 0;       // journal blocks replayed
+    size_t records  = 0;       // records applied from the journal
+    size_t rejected = 0;       // records that failed validation
+    size_t torn     = 0;       // bytes cut from the journal tail
+};
+
+//
+// Owned by the worker thread. open() and checkpoint() may also be called
+// from elsewhere while the worker is stopped.
+//
+class ParamStore
+{
+public:
+    static constexpr size_t kBlockRecords = 64;
+
+    // Checkpoint automatically once the journal exceeds this many bytes
+    // (0 = only when checkpoint() is called).
+    ParamStore(std::string snapshot_path, std::string journal_path, size_t checkpoint_bytes = 1u << 20)
+        : snapshotPath_(std::move(snapshot_path)), journalPath_(std::move(journal_path)),
+          checkpointBytes_(checkpoint_bytes)
+    {
+    }
+
+    ~ParamStore() { close(); }
+
+    ParamStore(const ParamStore&) = delete;
+    ParamStore& operator=(const ParamStore&) = delete;
+
+    //
+    // Warm start: load the snapshot into table, replay the matching
+    // journal on top and open the journal for appending. Missing files
+    // are not an error; table keeps its defaults for anything not found.
+    //
+    StoreOpenResult open(ParameterTable& table)
+    {
+        StoreOpenResult result;
+        close();
+        epoch_ = 0;
+
+        {
+            detail::MappedFile snap(snapshotPath_.c_str());
+            const auto* p = reinterpret_cast<const unsigned char*>(snap.begin());
+            const size_t n = snap.ok() ? static_cast<size_t>(snap.end() - snap.begin()) : 0;
+            if (n >= kSnapshotHeaderSize
+                && detail::load_le<uint32_t>(p) == kSnapshotMagic
+                && detail::load_le<uint16_t>(p + 4) == kStoreVersion
+                && detail::load_le<uint32_t>(p + 8) == detail::checksum(p + kSnapshotHeaderSize, n - kSnapshotHeaderSize)
+                && decode_table(p + kSnapshotHeaderSize, n - kSnapshotHeaderSize, table))
+            {
+                epoch_ = detail::load_le<uint64_t>(p + 16);
+                result.snapshot = true;
+            }
+        }
+
+        size_t good = 0;
+        {
+            detail::MappedFile journal(journalPath_.c_str());
+            const auto* p = reinterpret_cast<const unsigned char*>(journal.begin());
+            const size_t n = journal.ok() ? static_cast<size_t>(journal.end() - journal.begin()) : 0;
+            if (n >= kJournalHeaderSize
+                && detail::load_le<uint32_t>(p) == kJournalMagic
+                && detail::load_le<uint16_t>(p + 4) == kStoreVersion
+                && detail::load_le<uint64_t>(p + 8) == epoch_)
+            {
+                good = replay(p, n, table, result);
+                result.torn = n - good;
+            }
+        }
+
+        if (good == 0) return start_journal() ? result : StoreOpenResult{};
+
+        journalFd_ = ::open(journalPath_.c_str(), O_WRONLY | O_APPEND | O_CLOEXEC);
+        if (journalFd_ < 0) return StoreOpenResult{};
+        if (result.torn && (::ftruncate(journalFd_, static_cast<off_t>(good)) != 0 || ::fsync(journalFd_) != 0))
+        {
+            close();
+            return StoreOpenResult{};
+        }
+        journalBytes_ = good;
+        return result;
+    }
+
+    bool is_open() const { return journalFd_ >= 0; }
+
+    //
+    // Worker side: bracket the appends of one transaction, so a crash
+    // can never replay part of it. Blocks may still fill up in between.
+    //
+    void begin_group() { inGroup_ = true; }
+    void end_group() { inGroup_ = false; }
+
+    //
+    // Worker side: record one applied value for the current block.
+    // Returns false, and counts an error, if the value cannot be
+    // journaled (store not open, or writing a full block failed).
+    //
+    bool append(ParameterID id, const void* value)
+    {
+        const Handler* h = find_by_id(id);
+        if (!h || !is_open()) return failed();
+        if (count_ == kBlockRecords && !write_block()) return failed();
+        used_ += h->encode_binary(value, block_ + kJournalBlockHeaderSize + used_,
+                                  sizeof(block_) - kJournalBlockHeaderSize - used_);
+        ++count_;
+        return true;
+    }
+
+    //
+    // Worker side, once per drained batch: write the block with a single
+    // write() and fdatasync it. Checkpoints from table when the journal
+    // has grown past the limit. Returns false, and counts an error, on
+    // an I/O error.
+    //
+    bool commit(const ParameterTable& table)
+    {
+        if (!sync()) return failed();
+        if (checkpointBytes_ && journalBytes_ > checkpointBytes_ && !checkpoint(table)) return failed();
+        return true;
+    }
+
+    // Failed append() and commit() calls so far; safe from any thread.
+    uint64_t errors() const { return errors_.load(std::memory_order_relaxed); }
+
+    // Write a fresh snapshot of table and start an empty journal.
+    bool checkpoint(const ParameterTable& table)
+    {
+        if (!sync()) return false;
+
+        unsigned char buf[kSnapshotHeaderSize + kTableFrameSize]{};
+        const size_t frame = encode_table(table, buf + kSnapshotHeaderSize, kTableFrameSize);
+        detail::store_le(kSnapshotMagic, buf);
+        detail::store_le(kStoreVersion, buf + 4);
+        detail::store_le(detail::checksum(buf + kSnapshotHeaderSize, frame), buf + 8);
+        detail::store_le(epoch_ + 1, buf + 16);
+        if (!detail::replace_file(snapshotPath_, buf, kSnapshotHeaderSize + frame)) return false;
+
+        ++epoch_;
+        return start_journal();
+    }
+
+    // Syncs whatever is still pending.
+    void close()
+    {
+        if (journalFd_ >= 0)
+        {
+            sync();
+            ::close(journalFd_);
+        }
+        journalFd_ = -1;
+        count_ = used_ = 0;
+        unsynced_ = false;
+        inGroup_ = false;
+    }
+
+    uint64_t epoch() const { return epoch_; }
+    size_t journal_bytes() const { return journalBytes_; }
+
+private:
+    static constexpr size_t kBlockSize = kJournalBlockHeaderSize + kBlockRecords * detail::max_wire_size();
+
+    //
+    // Returns the offset just past the last intact block that does not
+    // end inside a transaction. A transaction's blocks go to a scratch
+    // copy of the table first, which replaces table once the last is in.
+    //
+    static size_t replay(const unsigned char* p, size_t n, ParameterTable& table, StoreOpenResult& result)
+    {
+        alignas(kMaxParameterAlign) unsigned char value[kMaxParameterSize];
+        size_t offset = kJournalHeaderSize;
+        size_t good = offset;
+        ParameterTable scratch;
+        StoreOpenResult pending;   // counts for the open transaction
+        bool inGroup = false;
+        while (n - offset >= kJournalBlockHeaderSize)
+        {
+            const unsigned char* b = p + offset;
+            const uint16_t records = detail::load_le<uint16_t>(b + 4);
+            const uint32_t bytes   = detail::load_le<uint32_t>(b + 8);
+            if (detail::load_le<uint32_t>(b) != kJournalBlockMagic
+                || bytes > n - offset - kJournalBlockHeaderSize
+                || detail::load_le<uint32_t>(b + 12) != detail::checksum(b + kJournalBlockHeaderSize, bytes))
+            {
+                break;
+            }
+
+            const bool continues = detail::load_le<uint16_t>(b + 6) & kBlockContinues;
+            if (continues && !inGroup)
+            {
+                scratch = table;
+                inGroup = true;
+            }
+            ParameterTable& into = inGroup ? scratch : table;
+            StoreOpenResult& counts = inGroup ? pending : result;
+
+            size_t at = kJournalBlockHeaderSize;
+            for (uint16_t i = 0; i < records; ++i)
+            {
+                BinaryRecordView rec(b + at, kJournalBlockHeaderSize + bytes - at);
+                const size_t size = rec.size();
+                if (size == 0) break;
+                if (rec.decode(value))
+                {
+                    into.set(rec.id(), value);
+                    ++counts.records;
+                }
+                else
+                {
+                    ++counts.rejected;
+                }
+                at += size;
+            }
+            ++counts.blocks;
+            offset += kJournalBlockHeaderSize + bytes;
+
+            if (inGroup && !continues)
+            {
+                table = scratch;
+                result.blocks   += pending.blocks;
+                result.records  += pending.records;
+                result.rejected += pending.rejected;
+                pending = {};
+                inGroup = false;
+            }
+            if (!inGroup) good = offset;
+        }
+        return good;
+    }
+
+    bool failed()
+    {
+        errors_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    bool start_journal()
+    {
+        close();
+        unsigned char header[kJournalHeaderSize]{};
+        detail::store_le(kJournalMagic, header);
+        detail::store_le(kStoreVersion, header + 4);
+        detail::store_le(epoch_, header + 8);
+        if (!detail::replace_file(journalPath_, header, sizeof(header))) return false;
+
+        journalFd_ = ::open(journalPath_.c_str(), O_WRONLY | O_APPEND | O_CLOEXEC);
+        journalBytes_ = kJournalHeaderSize;
+        return journalFd_ >= 0;
+    }
+
+    bool write_block()
+    {
+        if (count_ == 0) return true;
+        if (!is_open()) return false;
+
+        detail::store_le(kJournalBlockMagic, block_);
+        detail::store_le(static_cast<uint16_t>(count_), block_ + 4);
+        detail::store_le(inGroup_ ? kBlockContinues : uint16_t{0}, block_ + 6);
+        detail::store_le(static_cast<uint32_t>(used_), block_ + 8);
+        detail::store_le(detail::checksum(block_ + kJournalBlockHeaderSize, used_), block_ + 12);
+
+        const size_t n = kJournalBlockHeaderSize + used_;
+        count_ = used_ = 0;
+        if (!detail::write_all(journalFd_, block_, n)) return false;
+        journalBytes_ += n;
+        unsynced_ = true;
+        return true;
+    }
+
+    // Write the pending block and make everything written durable.
+    bool sync()
+    {
+        if (!write_block()) return false;
+        if (!unsynced_) return true;
+        unsynced_ = false;
+        return ::fdatasync(journalFd_) == 0;
+    }
+
+    std::string snapshotPath_;
+    std::string journalPath_;
+    size_t      checkpointBytes_;
+
+    int      journalFd_    = -1;
+    uint64_t epoch_        = 0;
+    size_t   journalBytes_ = 0;
+
+    unsigned char block_[kBlockSize]{};
+    size_t        count_ = 0;
+    size_t        used_  = 0;
+    bool          unsynced_ = false;
+    bool          inGroup_  = false;   // appends belong to one transaction
+
+    std::atomic<uint64_t> errors_{0};
+};
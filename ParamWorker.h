@@ -0,0 +1,495 @@
+#pragma once
+#include "ParameterTraits.h"
+#include "AsyncParams.h"
+#include "Backpressure.h"
+#include "ParamMessage.h"
+#include "ParameterSet.h"
+#include "ParameterTable.h"
+#include "HugePages.h"
+#include "ParamStore.h"
+#include "PayloadPool.h"
+#include "Metrics.h"
+#include "MPSCQueue.h"
+#include "RejectLog.h"
+#include "Seqlock.h"
+#include "Subscriptions.h"
+#include "SPSCQueue.h"
+#include "ThreadAffinity.h"
+#include "Transaction.h"
+#include "WaitPolicy.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <thread>
+
+// Producer and consumer run on different cores; keep their indices apart.
+using ParamQueue = SPSCQueue<Msg, 1024, QueueLayout::CacheAligned>;
+
+//
+// Several producers (HMI, network, recipes) can share one MPSC queue
+// instead of serializing behind a mutex.
+//
+using ParamMPSCQueue = MPSCQueue<Msg, 1024>;
+
+//
+// How a drained batch is applied.
+//
+// Immediate - every SetParam is validated and applied in arrival order.
+// Coalesce  - the batch is staged first, keeping only the newest value
+//             per ParameterID; each dirty parameter is then validated
+//             and applied once. A slider streaming hundreds of updates
+//             costs one validate/apply per batch. If the newest value is
+//             rejected the parameter keeps its current value. The
+//             cross-parameter rules see all valid staged values at once;
+//             if they fail, every staged value a rule reads is rejected
+//             and the rest are still applied.
+//
+enum class ApplyMode
+{
+    Immediate,
+    Coalesce
+};
+
+struct WorkerConfig
+{
+    // If set, the table is published here after every drained batch so
+    // other threads can read a consistent copy.
+    Seqlock<ParameterTable>* snapshot = nullptr;
+    ApplyMode mode = ApplyMode::Immediate;
+
+    // If set, subscribers are told once per batch which parameters
+    // changed, after the snapshot has been published.
+    const SubscriptionTable* subscriptions = nullptr;
+
+    // If set, rejected messages are copied here for a RejectReporter to
+    // print; the worker itself never formats or writes output.
+    RejectLog* rejects = nullptr;
+
+    // If set, queue and apply counters are recorded here. Compiles to
+    // nothing unless PARAMETER_TRAITS_METRICS is enabled.
+    WorkerMetrics* metrics = nullptr;
+
+    // Where MsgKind::Conflated markers find their values; shared with
+    // the ParamProducer that coalesces into it.
+    ConflationSlots* conflation = nullptr;
+
+    // If set, every applied value is journaled and each drained batch is
+    // committed (one write + fdatasync) before it is published. Failures
+    // are counted in ParamStore::errors() and the metrics' store_errors;
+    // the batch is still applied and published.
+    ParamStore* store = nullptr;
+
+    // If set, checked before every standalone update and every
+    // transaction is written; a failing rule rejects it.
+    const CrossRuleTable* rules = nullptr;
+
+    // Where MsgKind::SetBlob handles point, and where their values are
+    // copied before the slot is released. Both must be set for blobs.
+    PayloadPool* payloads = nullptr;
+    BlobTable*   blobs    = nullptr;
+
+    // If set, the outcome of every ticketed update is pushed here once
+    // its batch is applied; the AsyncParamClient reading it sizes it so
+    // it never fills.
+    CompletionRing* completions = nullptr;
+
+    // CPU or NUMA node the worker thread pins itself to on start.
+    ThreadPlacement placement;
+
+    // If non-zero, the worker thread runs SCHED_FIFO at this priority
+    // (1-99), so it is never preempted by ordinary threads. Unless it
+    // has a CPU to itself, keep a wait policy that blocks or yields.
+    int fifo_priority = 0;
+
+    // If set, the worker locks the whole process into RAM (mlockall of
+    // current and future pages) on start, so no page it touches faults.
+    bool lock_memory = false;
+
+    // Pages behind the ring and table, for containers that allocate
+    // them (ParamPool); see PageBox in HugePages.h.
+    PageBacking pages = PageBacking::Default;
+};
+
+// ------------------------
+// Consumer
+// ------------------------
+// Queue is any ring with the SPSCQueue interface (try_push, pop_bulk,
+// empty); with ParamMPSCQueue, try_post may be called from any thread.
+//
+template <typename Queue = ParamQueue, typename WaitPolicy = DefaultWaitPolicy>
+class ParamWorker
+{
+public:
+    ParamWorker(Queue& q, ParameterTable& tbl, const WorkerConfig& cfg = {})
+        : q_(q), table_(tbl), cfg_(cfg)
+    {
+    }
+
+    // Producer side: enqueue and wake the worker if its policy parked it.
+    bool try_post(const Msg& m)
+    {
+#if PARAMETER_TRAITS_METRICS
+        Msg stamped = m;
+        stamped.enqueue_ns = detail::metrics_now_ns();
+        const bool ok = q_.try_push(stamped);
+        if (cfg_.metrics) cfg_.metrics->on_push(ok);
+        if (!ok) return false;
+#else
+        if (!q_.try_push(m)) return false;
+#endif
+        wait_.notify();
+        return true;
+    }
+
+    //
+    // Enqueue up to n messages with one publish and one notify. Returns
+    // how many were taken; the rest are left for the caller to retry.
+    // Messages are stamped in place when metrics are enabled.
+    //
+    std::size_t try_post_n(Msg* msgs, std::size_t n)
+    {
+#if PARAMETER_TRAITS_METRICS
+        const uint64_t now = detail::metrics_now_ns();
+        for (std::size_t i = 0; i < n; ++i) msgs[i].enqueue_ns = now;
+#endif
+        const std::size_t pushed = q_.try_push_n(msgs, n);
+        if (cfg_.metrics) cfg_.metrics->on_push_n(pushed, n - pushed);
+        if (pushed) wait_.notify();
+        return pushed;
+    }
+
+    // Enqueue a contiguous run of n messages or nothing (stamped in
+    // place when metrics are enabled).
+    bool try_post_all(Msg* msgs, std::size_t n)
+    {
+#if PARAMETER_TRAITS_METRICS
+        const uint64_t now = detail::metrics_now_ns();
+        for (std::size_t i = 0; i < n; ++i) msgs[i].enqueue_ns = now;
+        const bool ok = q_.try_push_all(msgs, n);
+        if (cfg_.metrics) cfg_.metrics->on_push_n(ok ? n : 0, ok ? 0 : 1);
+        if (!ok) return false;
+#else
+        if (!q_.try_push_all(msgs, n)) return false;
+#endif
+        wait_.notify();
+        return true;
+    }
+
+    // Enqueue a whole transaction or nothing.
+    template <std::size_t N>
+    bool try_post(const Transaction<N>& t)
+    {
+#if PARAMETER_TRAITS_METRICS
+        Transaction<N> stamped = t;
+        const uint64_t now = detail::metrics_now_ns();
+        for (std::size_t i = 0; i < stamped.size(); ++i) stamped.data()[i].enqueue_ns = now;
+        const bool ok = q_.try_push_all(stamped.data(), stamped.size());
+        if (cfg_.metrics) cfg_.metrics->on_push_n(ok ? stamped.size() : 0, ok ? 0 : 1);
+        if (!ok) return false;
+#else
+        if (!q_.try_push_all(t.data(), t.size())) return false;
+#endif
+        wait_.notify();
+        return true;
+    }
+
+    // Returns once the thread has applied its placement, priority and
+    // memory lock; see setup_ok().
+    void start()
+    {
+        running_.store(true);
+        started_.store(false);
+        worker_ = std::thread([this] { run(); });
+        while (!started_.load(std::memory_order_acquire)) std::this_thread::yield();
+    }
+    void join() { if (worker_.joinable()) worker_.join(); }
+
+    // False if any requested placement, FIFO priority or memory lock
+    // was refused by the OS; the worker then runs without it.
+    bool setup_ok() const { return setupOk_; }
+
+private:
+    static constexpr std::size_t kBatch = 64;
+
+    void run()
+    {
+        setupOk_ = detail::apply_placement(cfg_.placement);
+        setupOk_ &= detail::apply_fifo_priority(cfg_.fifo_priority);
+        if (cfg_.lock_memory) setupOk_ &= detail::lock_all_memory();
+        started_.store(true, std::memory_order_release);
+
+        while (running_.load())
+        {
+            if constexpr (WorkerMetrics::enabled)
+            {
+                if (cfg_.metrics) cfg_.metrics->on_queue_depth(q_.size_approx());
+            }
+
+            // Drain a whole run of messages per acquire/release pair.
+            auto n = q_.pop_bulk([this](Msg&& m) { handle(m); }, kBatch);
+            if (n == 0)
+            {
+                wait_.wait([this] { return !q_.empty(); });
+                continue;
+            }
+            // A transaction split across drains is finished before anything
+            // is published.
+            if (txnRemaining_) continue;
+            if (cfg_.mode == ApplyMode::Coalesce) commit_staged();
+            if (cfg_.store && !cfg_.store->commit(table_) && cfg_.metrics) cfg_.metrics->on_store_error();
+            if (cfg_.snapshot) cfg_.snapshot->publish(table_);
+            if (cfg_.subscriptions && !changes_.empty()) changes_.dispatch(table_, *cfg_.subscriptions);
+            if (doneCount_) flush_completions();
+        }
+    }
+
+    void handle(const Msg& m)
+    {
+        if (m.kind == MsgKind::Stop)
+        {
+            running_.store(false);
+            return;
+        }
+        if (m.kind == MsgKind::TxnBegin)
+        {
+            // Anything staged is older than the transaction; write it
+            // first so the transaction is checked against, and wins
+            // over, it.
+            if (cfg_.mode == ApplyMode::Coalesce) commit_staged();
+            txnRemaining_ = m.txn_count();
+            return;
+        }
+        if (m.kind == MsgKind::Ticket)
+        {
+            ticket_ = m.ticket();
+            ticketed_ = cfg_.completions != nullptr;
+            return;
+        }
+#if PARAMETER_TRAITS_METRICS
+        if (cfg_.metrics) cfg_.metrics->on_handled(m.enqueue_ns);
+#endif
+        if (m.kind == MsgKind::SetBlob)
+        {
+            const bool ok = apply_blob(m);
+            if (ticketed_) complete(m.id, ok, RejectReason::BlobRejected);
+            return;
+        }
+
+        const Handler* h = find_by_id(m.id);
+        if (!h)
+        {
+            if (cfg_.metrics) cfg_.metrics->on_unknown();
+            if (cfg_.rejects) cfg_.rejects->report(m.id, m.payload, sizeof(m.payload), RejectReason::UnknownId);
+            drop(m.id, RejectReason::UnknownId);
+            return;
+        }
+
+        const void* value = m.payload;
+        Slot latest;
+        if (m.kind == MsgKind::Conflated)
+        {
+            if (!cfg_.conflation)
+            {
+                reject(*h, nullptr, RejectReason::NoValue);
+                drop(m.id, RejectReason::NoValue);
+                return;
+            }
+            cfg_.conflation->take(m.id, latest.bytes);
+            value = latest.bytes;
+        }
+
+        if (txnRemaining_)
+        {
+            const auto i = static_cast<std::size_t>(m.id);
+            std::memcpy(txnSlots_[i].bytes, value, h->size);
+            txnStaged_[i] = txnSlots_[i].bytes;
+            if (--txnRemaining_ == 0) commit_txn();
+        }
+        else if (cfg_.mode == ApplyMode::Coalesce && !ticketed_)
+        {
+            // Newest value wins; validated once in commit_staged().
+            std::memcpy(staged_[static_cast<std::size_t>(m.id)].bytes, value, h->size);
+            dirty_.insert(m.id);
+        }
+        else
+        {
+            // A ticketed update needs its own result, so it is applied
+            // now. Anything staged for the id is older: dropped if this
+            // was applied, still written in commit_staged() if not.
+            RejectReason why{};
+            const bool ok = apply(*h, value, m.kind == MsgKind::SetTrusted, &why);
+            if (ticketed_ && ok) dirty_.erase(m.id);
+            if (ticketed_) complete(m.id, ok, why);
+        }
+    }
+
+    // An update that carried no usable value still answers its ticket
+    // and, inside a transaction, aborts it.
+    void drop(ParameterID id, RejectReason why)
+    {
+        if (ticketed_) complete(id, false, why);
+        if (txnRemaining_)
+        {
+            txnFailed_ = true;
+            if (--txnRemaining_ == 0) commit_txn();
+        }
+    }
+
+    // A blob that does not fit its parameter (or has nowhere to go) is
+    // rejected as BlobRejected; either way the slot goes straight back
+    // to the pool.
+    bool apply_blob(const Msg& m)
+    {
+        const PayloadHandle h = blob_handle(m);
+        const bool ok = cfg_.payloads && cfg_.blobs
+                     && cfg_.blobs->set(blob_id_of(m), cfg_.payloads->data(h), h.size);
+        if (cfg_.payloads) cfg_.payloads->release(h);
+        if (!ok)
+        {
+            if (cfg_.metrics) cfg_.metrics->on_blob_rejected();
+            if (cfg_.rejects) cfg_.rejects->report(m.id, nullptr, 0, RejectReason::BlobRejected);
+        }
+        return ok;
+    }
+
+    // Held until the batch is committed and published, however long the
+    // drain. Every held outcome is a ticket still out, and the client
+    // never has more out than the ring holds, so done_ cannot fill.
+    void complete(ParameterID id, bool applied, RejectReason why)
+    {
+        ticketed_ = false;
+        done_[doneCount_++] = Completion{ ticket_, id, applied, why };
+    }
+
+    // Outcomes still in the ring are tickets out too, so the ring always
+    // has room for all of done_ and this does not wait.
+    void flush_completions()
+    {
+        std::size_t sent = 0;
+        while (sent < doneCount_)
+        {
+            const std::size_t n = cfg_.completions->try_push_n(done_.data() + sent, doneCount_ - sent);
+            if (n == 0) std::this_thread::yield();
+            sent += n;
+        }
+        doneCount_ = 0;
+    }
+
+    //
+    // Like commit_txn, but each value stands alone: an invalid one is
+    // rejected by itself. Values no rule reads cannot change the rules'
+    // outcome, so they are written even if the rules fail.
+    //
+    void commit_staged()
+    {
+        TxnView::Staged staged{};
+        dirty_.for_each([&](ParameterID id)
+        {
+            const auto i = static_cast<std::size_t>(id);
+            if (registry[i].validate(staged_[i].bytes)) staged[i] = staged_[i].bytes;
+            else reject(registry[i], staged_[i].bytes, RejectReason::OutOfRange);
+        });
+        const bool rules_ok = !cfg_.rules || cfg_.rules->empty() || cfg_.rules->check(TxnView(table_, staged));
+
+        dirty_.for_each([&](ParameterID id)
+        {
+            const auto i = static_cast<std::size_t>(id);
+            if (!staged[i]) return;
+            if (rules_ok || !cfg_.rules->reads().contains(id)) write(registry[i], staged[i]);
+            else reject(registry[i], staged[i], RejectReason::CrossRule);
+        });
+        dirty_.clear();
+    }
+
+    bool apply(const Handler& h, const void* value, bool trusted = false, RejectReason* why = nullptr)
+    {
+        if (!trusted && !h.validate(value))
+        {
+            reject(h, value, RejectReason::OutOfRange);
+            if (why) *why = RejectReason::OutOfRange;
+            return false;
+        }
+        if (cfg_.rules && !cfg_.rules->empty())
+        {
+            TxnView::Staged staged{};
+            staged[static_cast<std::size_t>(h.id)] = value;
+            if (!cfg_.rules->check(TxnView(table_, staged)))
+            {
+                reject(h, value, RejectReason::CrossRule);
+                if (why) *why = RejectReason::CrossRule;
+                return false;
+            }
+        }
+        write(h, value);
+        return true;
+    }
+
+    //
+    // All staged updates are validated, then the rules see the combined
+    // result; only if everything passes is anything written.
+    //
+    void commit_txn()
+    {
+        bool ok = !txnFailed_;
+        for (auto const& h : registry)
+        {
+            const void* v = txnStaged_[static_cast<std::size_t>(h.id)];
+            if (v && !h.validate(v)) ok = false;
+        }
+        const bool rules_ok = !ok || !cfg_.rules || cfg_.rules->check(TxnView(table_, txnStaged_));
+
+        // Journaled as one group, however many blocks it fills.
+        if (cfg_.store && ok && rules_ok) cfg_.store->begin_group();
+        for (auto const& h : registry)
+        {
+            const void* v = txnStaged_[static_cast<std::size_t>(h.id)];
+            if (!v) continue;
+            if (ok && rules_ok) write(h, v);
+            else if (!h.validate(v)) reject(h, v, RejectReason::OutOfRange);
+            else reject(h, v, ok ? RejectReason::CrossRule : RejectReason::Aborted);
+        }
+        if (cfg_.store) cfg_.store->end_group();
+        txnStaged_.fill(nullptr);
+        txnFailed_ = false;
+    }
+
+    void write(const Handler& h, const void* value)
+    {
+        if (cfg_.subscriptions) changes_.before_write(table_, h.id);
+        table_.set(h.id, value);
+        if (cfg_.store && !cfg_.store->append(h.id, value) && cfg_.metrics) cfg_.metrics->on_store_error();
+        if (cfg_.metrics) cfg_.metrics->on_applied(h.id);
+    }
+
+    void reject(const Handler& h, const void* value, RejectReason why)
+    {
+        if (cfg_.metrics) cfg_.metrics->on_rejected(h.id);
+        if (cfg_.rejects) cfg_.rejects->report(h.id, value, h.size, why);
+    }
+
+    struct Slot
+    {
+        alignas(kMaxParameterAlign) unsigned char bytes[kMaxParameterSize];
+    };
+
+    Queue& q_;
+    ParameterTable& table_;
+    WorkerConfig cfg_;
+    WaitPolicy wait_;
+    std::array<Slot, registryCount> staged_{};
+    ParameterSet dirty_;
+    std::array<Slot, registryCount> txnSlots_{};
+    TxnView::Staged txnStaged_{};
+    std::size_t txnRemaining_ = 0;
+    bool txnFailed_ = false;
+    uint32_t ticket_ = 0;
+    bool ticketed_ = false;   // the next update's outcome is wanted
+    std::array<Completion, CompletionRing::capacity> done_{};
+    std::size_t doneCount_ = 0;
+    ChangeTracker changes_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> started_{false};
+    bool setupOk_ = true;
+    std::thread worker_;
+};
@@ -0,0 +1,45 @@
+#pragma once
+
+//
+// The parameter schema: the one place a parameter is declared.
+//
+// X(Tag, member, UnderlyingType, default, min, max, precision, Backpressure, Lane)
+//
+//   Tag          - parameter type, generated as struct Tag { UnderlyingType member; }
+//   member       - name of its single field
+//   default      - initial value (ParameterTraits<Tag>::default_v)
+//   min, max     - inclusive bounds checked by validate/validate_bulk
+//   precision    - decimal places written by serialize (floats only)
+//   Backpressure - producer policy when the worker's queue is full
+//   Lane         - priority lane its updates travel in (see ParamLanes.h)
+//
+// From this list ParameterTraits.h generates ParameterID, the tag
+// structs, every ParameterTraits<Tag> specialization and AllParameters,
+// which in turn drives registry[], ParameterTable and the name index.
+// Rows are in ParameterID order; append new parameters at the end so
+// existing ids (and the binary wire format) stay stable.
+//
+// UnderlyingType may be float or any integral type.
+//
+#define PARAMETER_TRAITS_SCHEMA(X)                                                         \
+    X(TemperatureSetpoint,  value,     float, 37.5f, 0.0f, 100.0f, 2, Block,    Normal)     \
+    X(HighTemperatureAlarm, threshold, float, 80.0f, 0.0f, 150.0f, 2, Block,    Critical)   \
+    X(FanDutyCycle,         percent,   float, 50.0f, 0.0f, 100.0f, 2, Coalesce, Bulk)
+
+//
+// Variable-length parameters: strings, arrays and blobs.
+//
+// X(Tag, Element, capacity)
+//
+//   Tag      - parameter type, generated as an empty struct
+//   Element  - trivially copyable element type (char for text)
+//   capacity - most elements a value may hold
+//
+// These never travel in a Msg by value. The bytes go into a
+// PayloadPool slot and the message carries only its handle (see
+// PayloadPool.h); the worker copies them into its BlobTable. They have
+// their own BlobID space, in row order; append new rows at the end.
+//
+#define PARAMETER_TRAITS_BLOB_SCHEMA(X)          \
+    X(RecipeName,       char,  32)               \
+    X(CalibrationCurve, float, 64)
@@ -0,0 +1,77 @@
+#pragma once
+#include "ParameterTraits.h"
+#include "Platform.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+//
+// Fixed-size bitset with one bit per registered ParameterID. Used for
+// dirty/changed/valid tracking without allocating; for_each visits the
+// members in ParameterID order.
+//
+class ParameterSet
+{
+public:
+    static constexpr size_t kWords = (registryCount + 63) / 64;
+
+    void insert(ParameterID id)
+    {
+        const auto i = static_cast<size_t>(id);
+        if (i < registryCount) words_[i / 64] |= uint64_t{1} << (i % 64);
+    }
+
+    void erase(ParameterID id)
+    {
+        const auto i = static_cast<size_t>(id);
+        if (i < registryCount) words_[i / 64] &= ~(uint64_t{1} << (i % 64));
+    }
+
+    bool contains(ParameterID id) const
+    {
+        const auto i = static_cast<size_t>(id);
+        return i < registryCount && ((words_[i / 64] >> (i % 64)) & 1u);
+    }
+
+    bool empty() const
+    {
+        for (auto w : words_)
+            if (w) return false;
+        return true;
+    }
+
+    void clear() { words_ = {}; }
+
+    static ParameterSet all()
+    {
+        ParameterSet s;
+        for (auto const& h : registry) s.insert(h.id);
+        return s;
+    }
+
+    template <typename Fn>
+    void for_each(Fn&& fn) const
+    {
+        for (size_t w = 0; w < kWords; ++w)
+        {
+            for (uint64_t bits = words_[w]; bits; bits &= bits - 1)
+            {
+                fn(static_cast<ParameterID>(w * 64 + static_cast<size_t>(detail::countr_zero(bits))));
+            }
+        }
+    }
+
+    const std::array<uint64_t, kWords>& words() const { return words_; }
+
+private:
+    std::array<uint64_t, kWords> words_{};
+};
+
+// The set of the given parameters, e.g. parameter_set<A, B>().
+template <typename... Tags>
+ParameterSet parameter_set()
+{
+    ParameterSet s;
+    (s.insert(param_id<Tags>()), ...);
+    return s;
+}
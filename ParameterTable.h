@@ -0,0 +1,246 @@
+#pragma once
+#include "ParameterTraits.h"
+#include "ParameterSet.h"
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <type_traits>
+
+//
+// Parameter table generated from a ParamList.
+//
+// Values live back to back in one aligned byte array (one slot per
+// parameter, in ParameterID order), next to a validity bitset, so the
+// whole table spans a few cache lines. get<Tag>()/set<Tag>() resolve
+// their slot at compile time and fail to compile for a tag that is not
+// in the list; set(ParameterID, const void*) is the runtime path.
+//
+// A slot is valid once it holds a default or an applied value;
+// invalidate() marks it unusable until the next set.
+//
+// Every set that changes a value also stamps the slot with a new table
+// generation and marks it dirty, so exporters can send only what
+// changed: remember generation() after an export and ask
+// changed_since() next time, or use dirty()/clear_dirty() when a single
+// consumer owns the table. Defaults are generation 0.
+//
+template <typename List>
+class BasicParameterTable;
+
+template <typename... Tags>
+class BasicParameterTable<ParamList<Tags...>>
+{
+public:
+    static constexpr size_t count = sizeof...(Tags);
+
+    BasicParameterTable()
+    {
+        (construct<Tags>(), ...);
+    }
+
+    template <typename Tag>
+    static constexpr size_t index_of()
+    {
+        constexpr bool matches[] = { std::is_same_v<Tag, Tags>... };
+        for (size_t i = 0; i < count; ++i)
+            if (matches[i]) return i;
+        return count;
+    }
+
+    template <typename Tag>
+    const Tag& get() const
+    {
+        return *std::launder(reinterpret_cast<const Tag*>(storage_ + offsets_[slot<Tag>()]));
+    }
+
+    template <typename Tag>
+    void set(const Tag& v)
+    {
+        constexpr ParameterID id = param_id<Tag>();
+        const bool changed = differs(id, &v);
+        *std::launder(reinterpret_cast<Tag*>(storage_ + offsets_[slot<Tag>()])) = v;
+        touch(id, changed);
+    }
+
+    // Runtime flavour for type-erased values; p points at an object of
+    // the type registered for id.
+    void set(ParameterID id, const void* p)
+    {
+        const auto i = static_cast<size_t>(id);
+        if (i >= count) return;
+        const bool changed = differs(id, p);
+        std::memcpy(storage_ + offsets_[i], p, registry[i].size);
+        touch(id, changed);
+    }
+
+    const void* get(ParameterID id) const
+    {
+        const auto i = static_cast<size_t>(id);
+        return i < count ? storage_ + offsets_[i] : nullptr;
+    }
+
+    bool is_valid(ParameterID id) const { return valid_.contains(id); }
+
+    void invalidate(ParameterID id) { valid_.erase(id); }
+
+    // Number of changing sets so far; the generation of the newest one.
+    uint64_t generation() const { return generation_; }
+
+    uint64_t generation(ParameterID id) const
+    {
+        const auto i = static_cast<size_t>(id);
+        return i < count ? gens_[i] : 0;
+    }
+
+    // Parameters set after generation since.
+    ParameterSet changed_since(uint64_t since) const
+    {
+        ParameterSet changed;
+        if (since >= generation_) return changed;
+        for (size_t i = 0; i < count; ++i)
+            if (gens_[i] > since) changed.insert(static_cast<ParameterID>(i));
+        return changed;
+    }
+
+    // Parameters set since the last clear_dirty().
+    const ParameterSet& dirty() const { return dirty_; }
+    void clear_dirty() { dirty_.clear(); }
+
+    void print() const
+    {
+        char buf[32]{};
+        const char* sep = "Params { ";
+        for (auto const& h : registry)
+        {
+            int n = h.serialize(get(h.id), buf, sizeof(buf));
+            std::cout << sep << h.name << "=" << (n ? buf : "?");
+            sep = ", ";
+        }
+        std::cout << " }\n";
+    }
+
+private:
+    static_assert(count == registryCount, "ParameterTable list and registry[] disagree.");
+    static_assert((std::is_trivially_copyable_v<Tags> && ...), "Parameter types are stored as raw bytes.");
+
+    template <typename Tag>
+    static constexpr size_t slot()
+    {
+        constexpr size_t i = index_of<Tag>();
+        static_assert(i < count, "Tag has no storage slot in this ParameterTable.");
+        return i;
+    }
+
+    static constexpr std::array<size_t, count> compute_offsets()
+    {
+        std::array<size_t, count> offsets{};
+        size_t at = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const size_t align = registry[i].align;
+            at = (at + align - 1) / align * align;
+            offsets[i] = at;
+            at += registry[i].size;
+        }
+        return offsets;
+    }
+
+    static constexpr std::array<size_t, count> offsets_ = compute_offsets();
+    static constexpr size_t storageSize = count ? offsets_[count - 1] + registry[count - 1].size : 1;
+
+    bool differs(ParameterID id, const void* p) const
+    {
+        const auto i = static_cast<size_t>(id);
+        return !valid_.contains(id) || std::memcmp(storage_ + offsets_[i], p, registry[i].size) != 0;
+    }
+
+    void touch(ParameterID id, bool changed)
+    {
+        valid_.insert(id);
+        if (!changed) return;
+        dirty_.insert(id);
+        gens_[static_cast<size_t>(id)] = ++generation_;
+    }
+
+    template <typename Tag>
+    void construct()
+    {
+        ::new (static_cast<void*>(storage_ + offsets_[slot<Tag>()])) Tag(param_default<Tag>());
+        valid_.insert(param_id<Tag>());
+    }
+
+    alignas(kMaxParameterAlign) unsigned char storage_[storageSize];
+    ParameterSet valid_;
+    ParameterSet dirty_;
+    std::array<uint64_t, count> gens_{};
+    uint64_t generation_ = 0;
+};
+
+using ParameterTable = BasicParameterTable<AllParameters>;
+
+namespace detail
+{
+// Append "name=value\n" for h at out + used; false if it does not fit.
+inline bool append_line(const ParameterTable& table, const Handler& h, char* out, size_t n, size_t& used)
+{
+    const size_t nameLen = std::strlen(h.name);
+    // name, '=', at least one value char, '\n' and the final NUL
+    if (n - used < nameLen + 4)
+    {
+        return false;
+    }
+    std::memcpy(out + used, h.name, nameLen);
+    used += nameLen;
+    out[used++] = '=';
+
+    int w = h.serialize(table.get(h.id), out + used, n - used - 1);
+    if (w == 0)
+    {
+        return false;
+    }
+    used += static_cast<size_t>(w);
+    out[used++] = '\n';
+    return true;
+}
+}
+
+//
+// Write the whole table as "name=value" lines (the format load_config
+// reads) in a single pass. Returns the number of characters written,
+// excluding the terminating NUL, or 0 if out is too small.
+//
+inline size_t serialize_all(const ParameterTable& table, char* out, size_t n)
+{
+    size_t used = 0;
+    for (auto const& h : registry)
+    {
+        if (!detail::append_line(table, h, out, n, used)) return 0;
+    }
+    if (used == n) return 0;
+    out[used] = '\0';
+    return used;
+}
+
+//
+// Same, for only the parameters in ids, e.g. a delta:
+//
+//   const ParameterSet changed = table.changed_since(lastExport);
+//   if (!changed.empty() && serialize_set(table, changed, buf, sizeof(buf)))
+//       lastExport = table.generation();
+//
+// Returns 0 if out is too small (or ids is empty).
+//
+inline size_t serialize_set(const ParameterTable& table, const ParameterSet& ids, char* out, size_t n)
+{
+    size_t used = 0;
+    bool ok = true;
+    ids.for_each([&](ParameterID id)
+    {
+        ok = ok && detail::append_line(table, registry[static_cast<size_t>(id)], out, n, used);
+    });
+    if (!ok || used == 0 || used == n) return 0;
+    out[used] = '\0';
+    return used;
+}
@@ -9,65 +9,187 @@
 #include <charconv>
 #include <array>
 #include <cstring>
+#include <type_traits>
+
+#include "BulkValidate.h"
+#include "ParameterSchema.h"
 
 //
-// Parameter identities
+// Parameter identities, generated from PARAMETER_TRAITS_SCHEMA
 //
 enum class ParameterID : uint16_t
 {
-    TemperatureSetpoint,
-    HighTemperatureAlarm,
-    FanDutyCycle
+#define PARAMETER_TRAITS_GEN_ID(Tag, member, U, def, lo, hi, prec, bp, lane) Tag,
+    PARAMETER_TRAITS_SCHEMA(PARAMETER_TRAITS_GEN_ID)
+#undef PARAMETER_TRAITS_GEN_ID
 };
 
 //
-// Parameter types
+// What a producer does when the queue to the worker is full
+// (see ParamProducer in Backpressure.h).
 //
-struct TemperatureSetpoint
+// Block           - spin, then yield, for a bounded time; fail on timeout.
+// OverwriteOldest - keep the newest updates in a small producer-side
+//                   overflow ring and drop the oldest ones; for telemetry.
+// Coalesce        - at most one update per ParameterID is in flight; a
+//                   newer value replaces the queued one in place.
+//
+enum class Backpressure : uint8_t
 {
-    float value;
+    Block,
+    OverwriteOldest,
+    Coalesce
 };
 
-struct HighTemperatureAlarm
+//
+// Which of the worker's rings a parameter's updates travel in when the
+// worker drains a ParamLanes (see ParamLanes.h). Lower is more urgent.
+//
+// Critical - safety limits and alarms; always drained first.
+// Normal   - operator and control changes.
+// Bulk     - streamed or batch updates (sliders, recipes).
+//
+enum class Lane : uint8_t
 {
-    float threshold;
+    Critical,
+    Normal,
+    Bulk
 };
 
-struct FanDutyCycle
-{
-    float percent;
-};
+static constexpr size_t kLaneCount = 3;
 
 //
-// Non-allocating parse helper (from_chars -> fallback strtof)
+// Parameter types
+//
+#define PARAMETER_TRAITS_GEN_TAG(Tag, member, U, def, lo, hi, prec, bp, lane) \
+    struct Tag                                                                \
+    {                                                                         \
+        U member;                                                             \
+    };
+PARAMETER_TRAITS_SCHEMA(PARAMETER_TRAITS_GEN_TAG)
+#undef PARAMETER_TRAITS_GEN_TAG
+
 //
+// Non-allocating parse helpers (from_chars -> fallback strtof)
+//
+// The (first, last) and string_view flavours never scan for a
+// terminator. Define PARAMETER_TRAITS_NO_STRTOF_FALLBACK on toolchains
+// with full floating point from_chars to drop the locale-aware strtof
+// path entirely.
+//
+#if defined(__cpp_lib_to_chars) && (__cpp_lib_to_chars >= 201611)
+#define PARAMETER_TRAITS_HAS_FP_CHARCONV 1
+#endif
+
+#if defined(PARAMETER_TRAITS_NO_STRTOF_FALLBACK) && !defined(PARAMETER_TRAITS_HAS_FP_CHARCONV)
+#error "PARAMETER_TRAITS_NO_STRTOF_FALLBACK needs floating point std::from_chars"
+#endif
+
 namespace detail
 {
-inline bool parse_float(const char* in, float& out)
+#if !defined(PARAMETER_TRAITS_NO_STRTOF_FALLBACK)
+// The whole string must be the number; trailing text is an error.
+inline bool parse_float_strtof(const char* in, float& out)
 {
-    if (!in)
+    char* end{};
+    float v = std::strtof(in, &end);
+    if (end == in || *end != '\0')
     {
         return false;
     }
+    out = v;
+    return true;
+}
+#endif
 
-#if defined(__cpp_lib_to_chars) && (__cpp_lib_to_chars >= 201611)
-    const char* first = in;
-    const char* last  = in + std::strlen(in);
+// Succeeds only if all of [first, last) is the number, so "45xyz" or
+// "12.5.7" are rejected rather than read as 45 and 12.5.
+inline bool parse_float(const char* first, const char* last, float& out)
+{
+    if (!first || first == last)
+    {
+        return false;
+    }
+
+#if defined(PARAMETER_TRAITS_HAS_FP_CHARCONV)
     auto r = std::from_chars(first, last, out, std::chars_format::general);
-    if (r.ec == std::errc{} && r.ptr != first)
+    if (r.ec == std::errc{} && r.ptr == last)
     {
         return true;
     }
-    // fall through to strtof if lib doesn't fully support FP from_chars or input is quirky
 #endif
-    char* end{};
-    float v = std::strtof(in, &end);
-    if (end == in)
+
+#if defined(PARAMETER_TRAITS_NO_STRTOF_FALLBACK)
+    return false;
+#else
+    // fall back to strtof if lib doesn't fully support FP from_chars or
+    // input is quirky. strtof needs a terminator; numbers that long are
+    // not numbers we want.
+    char tmp[64];
+    const size_t n = static_cast<size_t>(last - first);
+    if (n >= sizeof(tmp))
     {
         return false;
     }
-    out = v;
-    return true;
+    std::memcpy(tmp, first, n);
+    tmp[n] = '\0';
+    return parse_float_strtof(tmp, out);
+#endif
+}
+
+inline bool parse_float(std::string_view in, float& out)
+{
+    return parse_float(in.data(), in.data() + in.size(), out);
+}
+
+// NUL-terminated flavour, kept for existing callers.
+inline bool parse_float(const char* in, float& out)
+{
+    if (!in)
+    {
+        return false;
+    }
+
+#if defined(PARAMETER_TRAITS_HAS_FP_CHARCONV)
+    const char* last = in + std::strlen(in);
+    auto r = std::from_chars(in, last, out, std::chars_format::general);
+    if (r.ec == std::errc{} && r.ptr == last)
+    {
+        return true;
+    }
+#endif
+
+#if defined(PARAMETER_TRAITS_NO_STRTOF_FALLBACK)
+    return false;
+#else
+    return parse_float_strtof(in, out);
+#endif
+}
+
+//
+// Fixed-precision float formatter: same text as snprintf("%.*f") and
+// the same contract as safe_snp (NUL-terminated, 0 on truncation), but
+// through to_chars instead of a varargs printf call when available.
+//
+inline int format_fixed(float value, int precision, char* out, size_t n)
+{
+    if (n == 0)
+    {
+        return 0;
+    }
+#if defined(PARAMETER_TRAITS_HAS_FP_CHARCONV)
+    auto r = std::to_chars(out, out + n - 1, value, std::chars_format::fixed, precision);
+    if (r.ec != std::errc{})
+    {
+        out[0] = '\0';
+        return 0;
+    }
+    *r.ptr = '\0';
+    return static_cast<int>(r.ptr - out);
+#else
+    int written = std::snprintf(out, n, "%.*f", precision, static_cast<double>(value));
+    return (written >= 0 && static_cast<size_t>(written) < n) ? written : 0;
+#endif
 }
 
 template <typename T>
@@ -81,116 +203,249 @@ inline int safe_snp(const char* fmt, const T& value, char* out, size_t n)
     // Return 0 on truncation so caller can handle gracefully.
     return (written >= 0 && static_cast<size_t>(written) < n) ? written : 0;
 }
-}
 
 //
-// ParameterTraits<T>
+// Underlying-type dispatch for the generated traits: floats go through
+// parse_float/format_fixed, integers through from_chars/to_chars.
 //
-template <typename T>
-struct ParameterTraits;
+inline bool parse_value(const char* first, const char* last, float& out) { return parse_float(first, last, out); }
+inline bool parse_value(const char* in, float& out) { return parse_float(in, out); }
+
+template <typename U, std::enable_if_t<std::is_integral_v<U>, int> = 0>
+inline bool parse_value(const char* first, const char* last, U& out)
+{
+    if (!first || first == last) return false;
+    auto r = std::from_chars(first, last, out);
+    return r.ec == std::errc{} && r.ptr == last;
+}
 
-// TemperatureSetpoint
-template <>
-struct ParameterTraits<TemperatureSetpoint>
+template <typename U, std::enable_if_t<std::is_integral_v<U>, int> = 0>
+inline bool parse_value(const char* in, U& out)
 {
-    using UnderlyingType = float;
+    return in && parse_value(in, in + std::strlen(in), out);
+}
 
-    static constexpr std::string_view name = "TemperatureSetpoint";
-    static constexpr TemperatureSetpoint default_v { 37.5f };
+inline int format_value(float value, int precision, char* out, size_t n) { return format_fixed(value, precision, out, n); }
 
-    static bool validate(const TemperatureSetpoint& x)
+template <typename U, std::enable_if_t<std::is_integral_v<U>, int> = 0>
+inline int format_value(U value, int, char* out, size_t n)
+{
+    if (n == 0) return 0;
+    auto r = std::to_chars(out, out + n - 1, value);
+    if (r.ec != std::errc{})
     {
-        return x.value >= 0.0f && x.value <= 100.0f;
+        out[0] = '\0';
+        return 0;
     }
+    *r.ptr = '\0';
+    return static_cast<int>(r.ptr - out);
+}
 
-    static bool parse(const char* in, TemperatureSetpoint& out)
+//
+// Little-endian binary records: [uint16 ParameterID][UnderlyingType].
+// Values are moved through an unsigned integer of the same width and
+// written byte by byte, so the encoding does not depend on host order.
+//
+constexpr size_t kRecordHeaderSize = sizeof(uint16_t);
+
+template <size_t N> struct unsigned_bits;
+template <> struct unsigned_bits<1> { using type = uint8_t; };
+template <> struct unsigned_bits<2> { using type = uint16_t; };
+template <> struct unsigned_bits<4> { using type = uint32_t; };
+template <> struct unsigned_bits<8> { using type = uint64_t; };
+
+template <typename U>
+PARAMETER_TRAITS_CODEC_CONSTEXPR void store_le(U value, unsigned char* out)
+{
+    const auto bits = bit_cast<typename unsigned_bits<sizeof(U)>::type>(value);
+    for (size_t i = 0; i < sizeof(U); ++i)
     {
-        float v{};
-        if (!detail::parse_float(in, v)) return false;
-        out.value = v;
-        return validate(out);
+        out[i] = static_cast<unsigned char>(bits >> (8 * i));
     }
+}
 
-    static int serialize(const TemperatureSetpoint& x, char* out, size_t n)
+template <typename U>
+PARAMETER_TRAITS_CODEC_CONSTEXPR U load_le(const unsigned char* in)
+{
+    using Bits = typename unsigned_bits<sizeof(U)>::type;
+    Bits bits = 0;
+    for (size_t i = 0; i < sizeof(U); ++i)
     {
-        return detail::safe_snp("%.2f", x.value, out, n);
+        bits |= static_cast<Bits>(static_cast<Bits>(in[i]) << (8 * i));
     }
-};
+    return bit_cast<U>(bits);
+}
+
+// Returns the record size, or 0 if out is too small.
+template <typename U>
+PARAMETER_TRAITS_CODEC_CONSTEXPR size_t encode_record(ParameterID id, U value, unsigned char* out, size_t n)
+{
+    constexpr size_t size = kRecordHeaderSize + sizeof(U);
+    if (n < size)
+    {
+        return 0;
+    }
+    store_le(static_cast<uint16_t>(id), out);
+    store_le(value, out + kRecordHeaderSize);
+    return size;
+}
+
+// Returns the record size, or 0 if in is short or holds another id.
+template <typename U>
+PARAMETER_TRAITS_CODEC_CONSTEXPR size_t decode_record(ParameterID id, const unsigned char* in, size_t n, U& value)
+{
+    constexpr size_t size = kRecordHeaderSize + sizeof(U);
+    if (n < size || load_le<uint16_t>(in) != static_cast<uint16_t>(id))
+    {
+        return 0;
+    }
+    value = load_le<U>(in + kRecordHeaderSize);
+    return size;
+}
+}
+
+//
+// ParameterTraits<T>
+//
+template <typename T>
+struct ParameterTraits;
 
-// HighTemperatureAlarm
-template <>
-struct ParameterTraits<HighTemperatureAlarm>
+namespace detail
 {
-    using UnderlyingType = float;
+//
+// Shared implementation behind every generated specialization. Self is
+// the ParameterTraits<Tag> specialization, which supplies id, name,
+// member, min_v, max_v and precision.
+//
+template <typename Self, typename Tag, typename U>
+struct ScalarTraits
+{
+    using UnderlyingType = U;
 
-    static constexpr std::string_view name = "HighTemperatureAlarm";
-    static constexpr HighTemperatureAlarm default_v { 80.0f };
+    static_assert(std::is_same_v<U, float> || std::is_integral_v<U>, "Parameters are float or integral.");
 
-    static bool validate(const HighTemperatureAlarm& x)
+    static constexpr bool validate(const Tag& x)
     {
-        return x.threshold >= 0.0f && x.threshold <= 150.0f;
+        return in_bounds(x.*Self::member, Self::min_v, Self::max_v);
     }
 
-    static bool parse(const char* in, HighTemperatureAlarm& out)
+    static bool parse(const char* in, Tag& out)
     {
-        float v{};
-        if (!detail::parse_float(in, v)) return false;
-        out.threshold = v;
+        U v{};
+        if (!parse_value(in, v)) return false;
+        out.*Self::member = v;
         return validate(out);
     }
 
-    static int serialize(const HighTemperatureAlarm& x, char* out, size_t n)
+    static bool parse(const char* first, const char* last, Tag& out)
     {
-        return detail::safe_snp("%.2f", x.threshold, out, n);
+        U v{};
+        if (!parse_value(first, last, v)) return false;
+        out.*Self::member = v;
+        return validate(out);
     }
-};
 
-// FanDutyCycle
-template <>
-struct ParameterTraits<FanDutyCycle>
-{
-    using UnderlyingType = float;
-
-    static constexpr std::string_view name = "FanDutyCycle";
-    static constexpr FanDutyCycle default_v { 50.0f };
+    static bool parse(std::string_view in, Tag& out)
+    {
+        return parse(in.data(), in.data() + in.size(), out);
+    }
 
-    static bool validate(const FanDutyCycle& x)
+    static int serialize(const Tag& x, char* out, size_t n)
     {
-        return x.percent >= 0.0f && x.percent <= 100.0f;
+        return format_value(x.*Self::member, Self::precision, out, n);
     }
 
-    static bool parse(const char* in, FanDutyCycle& out)
+    static PARAMETER_TRAITS_CODEC_CONSTEXPR size_t encode_binary(const Tag& x, unsigned char* out, size_t n)
     {
-        float v{};
-        if (!detail::parse_float(in, v)) return false;
-        out.percent = v;
-        return validate(out);
+        return encode_record(Self::id, x.*Self::member, out, n);
     }
 
-    static int serialize(const FanDutyCycle& x, char* out, size_t n)
+    static PARAMETER_TRAITS_CODEC_CONSTEXPR size_t decode_binary(const unsigned char* in, size_t n, Tag& out)
     {
-        return detail::safe_snp("%.2f", x.percent, out, n);
+        Tag v{};
+        size_t used = decode_record(Self::id, in, n, v.*Self::member);
+        if (!used || !validate(v)) return 0;
+        out = v;
+        return used;
     }
 };
+}
+
+#define PARAMETER_TRAITS_GEN_TRAITS(Tag, member_, U, def, lo, hi, prec, bp, lane_)              \
+    template <>                                                                                 \
+    struct ParameterTraits<Tag> : detail::ScalarTraits<ParameterTraits<Tag>, Tag, U>            \
+    {                                                                                           \
+        static constexpr ParameterID id = ParameterID::Tag;                                     \
+        static constexpr std::string_view name = #Tag;                                          \
+        static constexpr Tag default_v { def };                                                 \
+        static constexpr Backpressure backpressure = Backpressure::bp;                          \
+        static constexpr Lane lane = Lane::lane_;                                               \
+                                                                                                \
+        static constexpr U Tag::* member = &Tag::member_;                                       \
+        static constexpr U min_v = lo;                                                          \
+        static constexpr U max_v = hi;                                                          \
+        static constexpr int precision = prec;                                                  \
+    };
+PARAMETER_TRAITS_SCHEMA(PARAMETER_TRAITS_GEN_TRAITS)
+#undef PARAMETER_TRAITS_GEN_TRAITS
 
 //
 // Convenience compile-time dispatch
 //
+template <typename T>
+constexpr ParameterID param_id() { return ParameterTraits<T>::id; }
+
 template <typename T>
 constexpr std::string_view param_name() { return ParameterTraits<T>::name; }
 
 template <typename T>
 constexpr T param_default() { return ParameterTraits<T>::default_v; }
 
+template <typename T>
+constexpr Backpressure param_backpressure() { return ParameterTraits<T>::backpressure; }
+
+template <typename T>
+constexpr Lane param_lane() { return ParameterTraits<T>::lane; }
+
 template <typename T>
 bool param_parse(const char* in, T& out) { return ParameterTraits<T>::parse(in, out); }
 
 template <typename T>
-bool param_validate(const T& x) { return ParameterTraits<T>::validate(x); }
+bool param_parse(const char* first, const char* last, T& out) { return ParameterTraits<T>::parse(first, last, out); }
+
+template <typename T>
+bool param_parse(std::string_view in, T& out) { return ParameterTraits<T>::parse(in, out); }
+
+template <typename T>
+constexpr bool param_validate(const T& x) { return ParameterTraits<T>::validate(x); }
+
+//
+// Range-check n contiguous underlying values of parameter T against its
+// min_v/max_v (SIMD where available). Bit i of reject_mask is set for
+// each rejected value; reject_mask needs (n + 63) / 64 words. Returns
+// the number rejected.
+//
+template <typename T>
+size_t validate_bulk(const typename ParameterTraits<T>::UnderlyingType* values, size_t n, uint64_t* reject_mask)
+{
+    return detail::reject_mask(values, n, ParameterTraits<T>::min_v, ParameterTraits<T>::max_v, reject_mask);
+}
 
 template <typename T>
 int param_serialize(const T& x, char* out, size_t n) { return ParameterTraits<T>::serialize(x, out, n); }
 
+template <typename T>
+PARAMETER_TRAITS_CODEC_CONSTEXPR size_t param_encode_binary(const T& x, unsigned char* out, size_t n)
+{
+    return ParameterTraits<T>::encode_binary(x, out, n);
+}
+
+template <typename T>
+PARAMETER_TRAITS_CODEC_CONSTEXPR size_t param_decode_binary(const unsigned char* in, size_t n, T& out)
+{
+    return ParameterTraits<T>::decode_binary(in, n, out);
+}
+
 //
 // Type-erased runtime handlers and factory. Allows a homogeneous registry.
 //
@@ -199,10 +454,24 @@ struct Handler
     ParameterID id;
     const char* name;
     size_t      size;
+    size_t      align;
+    size_t      wire_size;  // encoded record size, header included
+    Backpressure backpressure;
+    Lane        lane;
 
     bool (*validate)(const void*);
     bool (*parse)(const char*, void*);
+    bool (*parse_range)(const char*, const char*, void*);
     int  (*serialize)(const void*, char*, size_t);
+    size_t (*encode_binary)(const void*, unsigned char*, size_t);
+    size_t (*decode_binary)(const unsigned char*, size_t, void*);
+    // values: n contiguous UnderlyingType values
+    size_t (*validate_bulk)(const void* values, size_t n, uint64_t* reject_mask);
+
+    bool parse_text(std::string_view in, void* p) const
+    {
+        return parse_range(in.data(), in.data() + in.size(), p);
+    }
 };
 
 //
@@ -217,6 +486,10 @@ constexpr Handler makeHandler(ParameterID id)
         id,
         ParameterTraits<T>::name.data(),
         sizeof(T),
+        alignof(T),
+        detail::kRecordHeaderSize + sizeof(typename ParameterTraits<T>::UnderlyingType),
+        ParameterTraits<T>::backpressure,
+        ParameterTraits<T>::lane,
         // validate
         [](const void* p) -> bool {
             return ParameterTraits<T>::validate(*static_cast<const T*>(p));
@@ -225,35 +498,268 @@ constexpr Handler makeHandler(ParameterID id)
         [](const char* in, void* p) -> bool {
             return ParameterTraits<T>::parse(in, *static_cast<T*>(p));
         },
+        // parse_range
+        [](const char* first, const char* last, void* p) -> bool {
+            return ParameterTraits<T>::parse(first, last, *static_cast<T*>(p));
+        },
         // serialize
         [](const void* p, char* out, size_t n) -> int {
             return ParameterTraits<T>::serialize(*static_cast<const T*>(p), out, n);
+        },
+        // encode_binary
+        [](const void* p, unsigned char* out, size_t n) -> size_t {
+            return ParameterTraits<T>::encode_binary(*static_cast<const T*>(p), out, n);
+        },
+        // decode_binary
+        [](const unsigned char* in, size_t n, void* p) -> size_t {
+            return ParameterTraits<T>::decode_binary(in, n, *static_cast<T*>(p));
+        },
+        // validate_bulk
+        [](const void* values, size_t n, uint64_t* reject_mask) -> size_t {
+            using U = typename ParameterTraits<T>::UnderlyingType;
+            return ::validate_bulk<T>(static_cast<const U*>(values), n, reject_mask);
         }
     };
 }
 
+//
+// The list of parameter types, in ParameterID order. Everything that
+// needs "one of each parameter" (registry[], ParameterTable storage) is
+// generated from it.
+//
+template <typename... Tags>
+struct ParamList
+{
+    static constexpr size_t size = sizeof...(Tags);
+};
+
+namespace detail
+{
+template <typename First, typename... Rest>
+struct DropFirst
+{
+    using type = ParamList<Rest...>;
+};
+}
+
+// Generated from PARAMETER_TRAITS_SCHEMA; the leading void soaks up the
+// comma each row emits.
+#define PARAMETER_TRAITS_GEN_LIST(Tag, member, U, def, lo, hi, prec, bp, lane) , Tag
+using AllParameters = detail::DropFirst<void PARAMETER_TRAITS_SCHEMA(PARAMETER_TRAITS_GEN_LIST)>::type;
+#undef PARAMETER_TRAITS_GEN_LIST
+
+template <typename... Tags>
+constexpr std::array<Handler, sizeof...(Tags)> makeRegistry(ParamList<Tags...>)
+{
+    return {{ makeHandler<Tags>(ParameterTraits<Tags>::id)... }};
+}
+
 //
 // A compile time array; each entry corresponds to the Handler for
 // the parameter indicated by the ParameterID enum.
 //
-static constexpr Handler registry[] {
-    makeHandler<TemperatureSetpoint>(ParameterID::TemperatureSetpoint),
-    makeHandler<HighTemperatureAlarm>(ParameterID::HighTemperatureAlarm),
-    makeHandler<FanDutyCycle>(ParameterID::FanDutyCycle)
-};
+static constexpr auto registry = makeRegistry(AllParameters{});
 
 static constexpr auto registryCount = std::size(registry);
 
-inline const Handler* find_by_id(ParameterID id)
+//
+// Largest size/alignment over all registered parameter types; anything
+// that carries a parameter value by type-erased bytes sizes itself
+// from these.
+//
+namespace detail
+{
+constexpr size_t max_handler_size()
+{
+    size_t m = 0;
+    for (auto const& h : registry) m = h.size > m ? h.size : m;
+    return m;
+}
+
+constexpr size_t max_handler_align()
+{
+    size_t m = 1;
+    for (auto const& h : registry) m = h.align > m ? h.align : m;
+    return m;
+}
+}
+
+static constexpr size_t kMaxParameterSize  = detail::max_handler_size();
+static constexpr size_t kMaxParameterAlign = detail::max_handler_align();
+
+//
+// O(1) lookups.
+//
+// registry[] is laid out in ParameterID order, so find_by_id is a bounds
+// check and an index. Names resolve through a perfect hash built at
+// compile time, so find_by_name hashes once and compares one string.
+//
+namespace detail
+{
+constexpr bool registry_in_id_order()
+{
+    for (size_t i = 0; i < registryCount; ++i)
+        if (static_cast<size_t>(registry[i].id) != i) return false;
+    return true;
+}
+
+constexpr uint32_t fnv1a(std::string_view s)
+{
+    uint32_t h = 2166136261u;
+    for (char c : s)
+    {
+        h ^= static_cast<unsigned char>(c);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+constexpr uint32_t mix32(uint32_t h)
+{
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+    return h;
+}
+
+constexpr size_t next_pow2(size_t n)
+{
+    size_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+//
+// "Hash and displace": the name hash picks a bucket, and that bucket's
+// displacement is mixed back into the same hash to pick a slot. The
+// displacements are searched at compile time so no two names share a
+// slot.
+//
+struct NameIndex
+{
+    static constexpr size_t buckets = next_pow2(registryCount);
+    static constexpr size_t slots   = 2 * next_pow2(registryCount);
+    static constexpr uint32_t maxDisplacement = 1u << 16;
+
+    std::array<uint32_t, buckets>               displacement{};
+    std::array<uint16_t, slots>                 entry{};  // registry index + 1, 0 = empty
+    std::array<std::string_view, registryCount> names{};
+    bool ok = true;
+
+    static constexpr uint32_t bucket_of(uint32_t h) { return h & (buckets - 1); }
+
+    static constexpr uint32_t slot_of(uint32_t h, uint32_t d)
+    {
+        return mix32(h ^ (d * 0x9e3779b9u)) & (slots - 1);
+    }
+};
+
+constexpr NameIndex build_name_index()
+{
+    NameIndex idx{};
+    std::array<uint32_t, registryCount> hash{};
+    std::array<size_t, NameIndex::buckets> bucketSize{};
+    size_t largest = 0;
+
+    for (size_t i = 0; i < registryCount; ++i)
+    {
+        idx.names[i] = registry[i].name;
+        hash[i] = fnv1a(idx.names[i]);
+        size_t& n = bucketSize[NameIndex::bucket_of(hash[i])];
+        if (++n > largest) largest = n;
+    }
+
+    // Place the most crowded buckets first, while the table is sparse.
+    for (size_t size = largest; size > 0; --size)
+    {
+        for (uint32_t b = 0; b < NameIndex::buckets; ++b)
+        {
+            if (bucketSize[b] != size) continue;
+
+            bool placed = false;
+            for (uint32_t d = 0; d < NameIndex::maxDisplacement && !placed; ++d)
+            {
+                placed = true;
+                for (size_t i = 0; i < registryCount && placed; ++i)
+                {
+                    if (NameIndex::bucket_of(hash[i]) != b) continue;
+                    auto& e = idx.entry[NameIndex::slot_of(hash[i], d)];
+                    if (e) placed = false;
+                    else e = static_cast<uint16_t>(i + 1);
+                }
+                if (placed)
+                {
+                    idx.displacement[b] = d;
+                    break;
+                }
+                // Undo this attempt's tentative placements.
+                for (size_t i = 0; i < registryCount; ++i)
+                {
+                    if (NameIndex::bucket_of(hash[i]) != b) continue;
+                    auto& e = idx.entry[NameIndex::slot_of(hash[i], d)];
+                    if (e == i + 1) e = 0;
+                }
+            }
+            if (!placed)
+            {
+                idx.ok = false;
+                return idx;
+            }
+        }
+    }
+    return idx;
+}
+
+static constexpr NameIndex kNameIndex = build_name_index();
+}
+
+namespace detail
+{
+template <typename... Tags>
+constexpr bool defaults_valid(ParamList<Tags...>)
+{
+    return (ParameterTraits<Tags>::validate(ParameterTraits<Tags>::default_v) && ...);
+}
+
+#if defined(PARAMETER_TRAITS_HAS_BIT_CAST)
+template <typename Tag>
+constexpr bool default_round_trips()
+{
+    unsigned char buf[kRecordHeaderSize + sizeof(typename ParameterTraits<Tag>::UnderlyingType)]{};
+    Tag back{};
+    return param_encode_binary(param_default<Tag>(), buf, sizeof(buf)) == sizeof(buf)
+        && param_decode_binary(buf, sizeof(buf), back) == sizeof(buf)
+        && back.*ParameterTraits<Tag>::member == param_default<Tag>().*ParameterTraits<Tag>::member;
+}
+
+template <typename... Tags>
+constexpr bool defaults_round_trip(ParamList<Tags...>)
+{
+    return (default_round_trips<Tags>() && ...);
+}
+#endif
+}
+
+static_assert(detail::registry_in_id_order(), "registry[] entries must be listed in ParameterID order.");
+static_assert(detail::kNameIndex.ok, "Could not build the name index; are two parameters sharing a name?");
+static_assert(detail::defaults_valid(AllParameters{}), "Every registered default_v must pass its own validate().");
+#if defined(PARAMETER_TRAITS_HAS_BIT_CAST)
+static_assert(detail::defaults_round_trip(AllParameters{}), "Binary codec must round-trip every default_v.");
+#endif
+
+constexpr const Handler* find_by_id(ParameterID id)
 {
-    for (auto const& h : registry)
-        if (h.id == id) return &h;
-    return nullptr;
+    const auto i = static_cast<size_t>(id);
+    return i < registryCount ? &registry[i] : nullptr;
 }
 
-inline const Handler* find_by_name(std::string_view name)
+constexpr const Handler* find_by_name(std::string_view name)
 {
-    for (auto const& h : registry)
-        if (name == h.name) return &h;
-    return nullptr;
+    using detail::NameIndex;
+    const auto& idx = detail::kNameIndex;
+    const uint32_t h = detail::fnv1a(name);
+    const uint16_t e = idx.entry[NameIndex::slot_of(h, idx.displacement[NameIndex::bucket_of(h)])];
+    return (e && idx.names[e - 1] == name) ? &registry[e - 1] : nullptr;
 }
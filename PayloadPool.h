@@ -0,0 +1,167 @@
+#pragma once
+#include "BlobParameters.h"
+#include "ParamMessage.h"
+#include "Platform.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+//
+// Handle to a PayloadPool slot holding size bytes. It is what a
+// MsgKind::SetBlob message carries in its payload.
+//
+struct PayloadHandle
+{
+    uint16_t slot = 0;
+    uint16_t size = 0;
+};
+
+static_assert(sizeof(PayloadHandle) <= kMaxParameterSize, "A PayloadHandle must fit a Msg payload.");
+
+//
+// Fixed pool of Slots buffers of SlotSize bytes, shared by producers and
+// the worker. Producers acquire a slot, fill it and enqueue its handle;
+// the worker releases it once the value is committed. Free slots form a
+// lock-free stack (index plus an ABA tag in one 64-bit word), so acquire
+// and release are a CAS each from any thread and nothing is allocated
+// after construction.
+//
+// The queue carrying the handle orders the producer's writes before the
+// worker's reads; release/acquire on the free list orders the worker's
+// reads before the next producer's writes.
+//
+template <std::size_t SlotSize, std::size_t Slots = 64>
+class BasicPayloadPool
+{
+    static_assert(SlotSize > 0 && SlotSize <= 0xFFFF, "Payload sizes travel as uint16.");
+    static_assert(Slots > 0 && Slots < 0xFFFF, "Slot indices travel as uint16.");
+
+public:
+    static constexpr std::size_t slot_size = SlotSize;
+    static constexpr std::size_t slots     = Slots;
+
+    BasicPayloadPool()
+    {
+        for (std::size_t i = 0; i < Slots; ++i)
+        {
+            next_[i].store(static_cast<uint32_t>(i + 1 < Slots ? i + 1 : kNil), std::memory_order_relaxed);
+        }
+        head_.store(pack(0, 0), std::memory_order_relaxed);
+    }
+
+    BasicPayloadPool(const BasicPayloadPool&) = delete;
+    BasicPayloadPool& operator=(const BasicPayloadPool&) = delete;
+
+    // Copy n bytes into a free slot. False if n is too large or the pool
+    // is exhausted (counted in exhausted()).
+    bool store(const void* bytes, std::size_t n, PayloadHandle& out)
+    {
+        if (n > SlotSize) return false;
+        uint32_t slot;
+        if (!pop(slot))
+        {
+            exhausted_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        if (n) std::memcpy(slots_[slot].bytes, bytes, n);
+        out = PayloadHandle{ static_cast<uint16_t>(slot), static_cast<uint16_t>(n) };
+        return true;
+    }
+
+    const unsigned char* data(PayloadHandle h) const { return slots_[h.slot].bytes; }
+
+    void release(PayloadHandle h)
+    {
+        const uint32_t slot = h.slot;
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        do
+        {
+            next_[slot].store(index(head), std::memory_order_relaxed);
+        } while (!head_.compare_exchange_weak(head, pack(tag(head) + 1, slot),
+                                              std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    // Failed stores since construction.
+    uint64_t exhausted() const { return exhausted_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr uint32_t kNil = 0xFFFFFFFFu;
+
+    static constexpr uint64_t pack(uint32_t tag, uint32_t index) { return (uint64_t(tag) << 32) | index; }
+    static constexpr uint32_t tag(uint64_t v) { return static_cast<uint32_t>(v >> 32); }
+    static constexpr uint32_t index(uint64_t v) { return static_cast<uint32_t>(v); }
+
+    bool pop(uint32_t& slot)
+    {
+        uint64_t head = head_.load(std::memory_order_acquire);
+        while (index(head) != kNil)
+        {
+            // next_ may be stale if another thread popped this slot first;
+            // the tag then makes the CAS fail and we retry.
+            const uint32_t next = next_[index(head)].load(std::memory_order_relaxed);
+            if (head_.compare_exchange_weak(head, pack(tag(head) + 1, next),
+                                            std::memory_order_acquire, std::memory_order_acquire))
+            {
+                slot = index(head);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    struct Slot
+    {
+        alignas(kMaxBlobAlign) unsigned char bytes[SlotSize];
+    };
+
+    alignas(kCacheLineSize) std::atomic<uint64_t> head_{0};
+    std::atomic<uint64_t> exhausted_{0};
+    std::array<std::atomic<uint32_t>, Slots> next_{};
+    std::array<Slot, Slots> slots_{};
+};
+
+// Slots big enough for the largest blob parameter, a cache line apiece.
+using PayloadPool = BasicPayloadPool<(kMaxBlobBytes + kCacheLineSize - 1) / kCacheLineSize * kCacheLineSize>;
+
+//
+// SetBlob messages: id holds the BlobID, the payload the handle.
+//
+inline Msg blob_msg(BlobID id, PayloadHandle h)
+{
+    Msg m;
+    m.id   = static_cast<ParameterID>(id);
+    m.kind = MsgKind::SetBlob;
+    std::memcpy(m.payload, &h, sizeof(h));
+    return m;
+}
+
+inline BlobID blob_id_of(const Msg& m) { return static_cast<BlobID>(m.id); }
+
+inline PayloadHandle blob_handle(const Msg& m)
+{
+    PayloadHandle h;
+    std::memcpy(&h, m.payload, sizeof(h));
+    return h;
+}
+
+//
+// Copy count elements into a pool slot and post its handle to sink (a
+// ParamWorker or ParamRouter). False if the value is too long, the pool
+// is exhausted or the sink refused; no slot is held then.
+//
+template <typename Tag, typename Sink, std::size_t SlotSize, std::size_t Slots>
+bool post_blob(Sink& sink, BasicPayloadPool<SlotSize, Slots>& pool,
+               const typename BlobTraits<Tag>::Element* data, std::size_t count)
+{
+    static_assert(BlobTraits<Tag>::capacity * sizeof(typename BlobTraits<Tag>::Element) <= SlotSize,
+                  "Pool slots are smaller than this blob parameter.");
+    if (count > BlobTraits<Tag>::capacity) return false;
+
+    PayloadHandle h;
+    if (!pool.store(data, count * sizeof(*data), h)) return false;
+    if (sink.try_post(blob_msg(blob_id<Tag>(), h))) return true;
+    pool.release(h);
+    return false;
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+//
+// Size used to keep independently written data on separate cache lines.
+// Define PARAMETER_TRAITS_CACHE_LINE_SIZE to pin it for a target.
+//
+#if defined(PARAMETER_TRAITS_CACHE_LINE_SIZE)
+inline constexpr std::size_t kCacheLineSize = PARAMETER_TRAITS_CACHE_LINE_SIZE;
+#elif defined(__cpp_lib_hardware_interference_size)
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winterference-size"
+#endif
+inline constexpr std::size_t kCacheLineSize = std::hardware_destructive_interference_size;
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#else
+inline constexpr std::size_t kCacheLineSize = 64;
+#endif
+
+//
+// C++17 has no std::bit_cast, but GCC 11+, Clang 9+ and MSVC provide
+// the builtin behind it. With it, the binary codec is constexpr;
+// PARAMETER_TRAITS_CODEC_CONSTEXPR marks the functions that depend on it.
+//
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_bit_cast)
+#define PARAMETER_TRAITS_HAS_BIT_CAST 1
+#endif
+#elif defined(_MSC_VER) && _MSC_VER >= 1926
+#define PARAMETER_TRAITS_HAS_BIT_CAST 1
+#endif
+
+#if defined(PARAMETER_TRAITS_HAS_BIT_CAST)
+#define PARAMETER_TRAITS_CODEC_CONSTEXPR constexpr
+#else
+#define PARAMETER_TRAITS_CODEC_CONSTEXPR inline
+#endif
+
+namespace detail
+{
+// Spin-loop hint: lets the sibling hyperthread run and saves power.
+inline void cpu_relax()
+{
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+template <typename To, typename From>
+PARAMETER_TRAITS_CODEC_CONSTEXPR To bit_cast(const From& from)
+{
+    static_assert(sizeof(To) == sizeof(From), "bit_cast needs equal sizes.");
+    static_assert(std::is_trivially_copyable_v<To> && std::is_trivially_copyable_v<From>, "bit_cast needs trivial types.");
+#if defined(PARAMETER_TRAITS_HAS_BIT_CAST)
+    return __builtin_bit_cast(To, from);
+#else
+    To to;
+    std::memcpy(&to, &from, sizeof(To));
+    return to;
+#endif
+}
+
+// Index of the lowest set bit; x must not be 0.
+inline int countr_zero(uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#else
+    int n = 0;
+    while (!(x & 1)) { x >>= 1; ++n; }
+    return n;
+#endif
+}
+
+inline int popcount(uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(x);
+#else
+    int n = 0;
+    for (; x; x &= x - 1) ++n;
+    return n;
+#endif
+}
+}
@@ -0,0 +1,167 @@
+#pragma once
+#include "ParameterTraits.h"
+#include "BlobParameters.h"
+#include "SPSCQueue.h"
+#include "WaitPolicy.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <utility>
+
+enum class RejectReason : uint8_t
+{
+    UnknownId,
+    OutOfRange,
+    CrossRule,     // valid alone, but broke a cross-parameter rule
+    Aborted,       // valid, but another update in its transaction was not
+    NoValue,       // Conflated marker with no ConflationSlots to read it from
+    BlobRejected   // blob value did not fit, or the worker has no BlobTable
+};
+
+inline const char* to_string(RejectReason r)
+{
+    switch (r)
+    {
+    case RejectReason::UnknownId:    return "unknown parameter id";
+    case RejectReason::OutOfRange:   return "out of range";
+    case RejectReason::CrossRule:    return "cross-parameter rule";
+    case RejectReason::Aborted:      return "transaction aborted";
+    case RejectReason::NoValue:      return "no conflated value";
+    case RejectReason::BlobRejected: return "blob not stored";
+    }
+    return "?";
+}
+
+//
+// One rejected SetParam, copied verbatim off the hot path. Formatting
+// happens later on the reporter thread. For BlobRejected, id holds the
+// BlobID and value is empty.
+//
+struct RejectRecord
+{
+    uint64_t timestamp_ns = 0;   // steady_clock
+    alignas(kMaxParameterAlign) unsigned char value[kMaxParameterSize]{};
+    ParameterID  id{};
+    RejectReason reason{};
+};
+
+//
+// Lock-free diagnostic ring between the worker (single producer) and a
+// RejectReporter (single consumer). report() never blocks: when the
+// ring is full the record is dropped and counted instead.
+//
+template <std::size_t CapacityPow2 = 256>
+class BasicRejectLog
+{
+public:
+    void report(ParameterID id, const void* value, std::size_t size, RejectReason reason)
+    {
+        RejectRecord r;
+        r.timestamp_ns = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+        if (value) std::memcpy(r.value, value, size < sizeof(r.value) ? size : sizeof(r.value));
+        r.id     = id;
+        r.reason = reason;
+        if (!ring_.try_push(r)) dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Consumer side.
+    template <typename Fn>
+    std::size_t drain(Fn&& fn, std::size_t max) { return ring_.pop_bulk(std::forward<Fn>(fn), max); }
+    bool empty() const { return ring_.empty(); }
+
+    // Records lost to overflow since construction.
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    SPSCQueue<RejectRecord, CapacityPow2, QueueLayout::CacheAligned> ring_;
+    std::atomic<uint64_t> dropped_{0};
+};
+
+using RejectLog = BasicRejectLog<>;
+
+//
+// Low-priority thread that drains a RejectLog and prints each record as
+// "[Reject] name value (reason)". New drops are reported as a single
+// line. It polls with a sleeping policy so it never competes with the
+// worker for a core.
+//
+template <typename Log = RejectLog, typename WaitPolicy = SleepWait<1000>>
+class RejectReporter
+{
+public:
+    explicit RejectReporter(Log& log, std::ostream& out = std::cout) : log_(log), out_(out) {}
+    ~RejectReporter() { stop(); }
+
+    void start()
+    {
+        stop_.store(false);
+        thread_ = std::thread([this] { run(); });
+    }
+
+    // Prints whatever is still queued, then returns.
+    void stop()
+    {
+        stop_.store(true);
+        if (thread_.joinable()) thread_.join();
+    }
+
+private:
+    static constexpr std::size_t kBatch = 64;
+
+    void run()
+    {
+        while (true)
+        {
+            wait_.wait([this] { return stop_.load() || !log_.empty(); });
+            while (log_.drain([this](RejectRecord&& r) { print(r); }, kBatch) != 0) {}
+            report_dropped();
+            if (stop_.load() && log_.empty()) break;
+        }
+        out_.flush();
+    }
+
+    void print(const RejectRecord& r)
+    {
+        if (r.reason == RejectReason::BlobRejected)
+        {
+            const BlobHandler* b = find_blob(static_cast<BlobID>(r.id));
+            out_ << "[Reject] " << (b ? b->name : "blob") << " (" << to_string(r.reason) << ")\n";
+            return;
+        }
+        const Handler* h = r.reason == RejectReason::UnknownId ? nullptr : find_by_id(r.id);
+        if (!h)
+        {
+            out_ << "[Reject] " << to_string(RejectReason::UnknownId) << " " << static_cast<unsigned>(r.id) << "\n";
+            return;
+        }
+        if (r.reason == RejectReason::NoValue)
+        {
+            out_ << "[Reject] " << h->name << " (" << to_string(r.reason) << ")\n";
+            return;
+        }
+        char buf[32]{};
+        h->serialize(r.value, buf, sizeof(buf));
+        out_ << "[Reject] " << h->name << " " << buf << " (" << to_string(r.reason) << ")\n";
+    }
+
+    void report_dropped()
+    {
+        const uint64_t dropped = log_.dropped();
+        if (dropped == reported_) return;
+        out_ << "[Reject] " << (dropped - reported_) << " records dropped\n";
+        reported_ = dropped;
+    }
+
+    Log& log_;
+    std::ostream& out_;
+    WaitPolicy wait_;
+    uint64_t reported_ = 0;
+    std::atomic<bool> stop_{false};
+    std::thread thread_;
+};
@@ -0,0 +1,189 @@
+#pragma once
+#include "Platform.h"
+#include <atomic>
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <utility>
+
+//
+// Memory layout of the SPSCQueue indices.
+//
+// Compact      - head_ and tail_ share a cache line; every push and pop
+//                reads the other side's index.
+// CacheAligned - each index lives on its own cache line together with a
+//                private copy of the other side's index. The shared
+//                atomic is only re-read when the ring looks full (producer)
+//                or empty (consumer), so the lines stop ping-ponging.
+//
+enum class QueueLayout
+{
+    Compact,
+    CacheAligned
+};
+
+namespace detail
+{
+template <QueueLayout Layout>
+struct SPSCIndices;
+
+template <>
+struct SPSCIndices<QueueLayout::Compact>
+{
+    std::atomic<std::size_t> head{0}, tail{0};
+};
+
+template <>
+struct SPSCIndices<QueueLayout::CacheAligned>
+{
+    // Producer line
+    alignas(kCacheLineSize) std::atomic<std::size_t> head{0};
+    std::size_t cachedTail{0};
+
+    // Consumer line
+    alignas(kCacheLineSize) std::atomic<std::size_t> tail{0};
+    std::size_t cachedHead{0};
+};
+}
+
+//
+// Simple lock-free SPSC (Single Producer Single Consumer) ring buffer.
+//
+// One slot is always left empty to tell "full" from "empty", so the
+// usable capacity is CapacityPow2 - 1.
+//
+template <typename T, std::size_t CapacityPow2, QueueLayout Layout = QueueLayout::Compact>
+class SPSCQueue
+{
+    static_assert((CapacityPow2 & (CapacityPow2 - 1)) == 0, "Capacity must be power of two.");
+
+public:
+    static constexpr std::size_t capacity = CapacityPow2 - 1;
+    static constexpr QueueLayout layout = Layout;
+
+    bool try_push(const T& v) { return try_push(T(v)); }
+
+    bool try_push(T&& v)
+    {
+        const std::size_t head = idx_.head.load(std::memory_order_relaxed);
+        if (free_slots(head, 1) == 0) return false;
+        buf_[head] = std::move(v);
+        idx_.head.store((head + 1) & mask_, std::memory_order_release);
+        return true;
+    }
+
+    //
+    // Copy up to n elements starting at first into the ring and publish
+    // them with a single release store of head_. Returns the number of
+    // elements actually pushed (less than n when the ring fills up).
+    //
+    template <typename InputIt>
+    std::size_t try_push_n(InputIt first, std::size_t n)
+    {
+        const std::size_t head = idx_.head.load(std::memory_order_relaxed);
+        const std::size_t free = free_slots(head, n);
+        const std::size_t count = n < free ? n : free;
+        for (std::size_t i = 0; i < count; ++i, ++first)
+        {
+            buf_[(head + i) & mask_] = *first;
+        }
+        if (count) idx_.head.store((head + count) & mask_, std::memory_order_release);
+        return count;
+    }
+
+    // All n elements or none; the run is published with one store.
+    template <typename InputIt>
+    bool try_push_all(InputIt first, std::size_t n)
+    {
+        const std::size_t head = idx_.head.load(std::memory_order_relaxed);
+        if (free_slots(head, n) < n) return false;
+        return try_push_n(first, n) == n;
+    }
+
+    std::optional<T> try_pop()
+    {
+        const std::size_t tail = idx_.tail.load(std::memory_order_relaxed);
+        if (available(tail, 1) == 0) return std::nullopt;
+        T v = std::move(buf_[tail]);
+        idx_.tail.store((tail + 1) & mask_, std::memory_order_release);
+        return v;
+    }
+
+    //
+    // Consume up to max elements, handing each one to fn in FIFO order,
+    // then release all of their slots with a single store of tail_.
+    // Returns the number of elements consumed.
+    //
+    template <typename Fn>
+    std::size_t pop_bulk(Fn&& fn, std::size_t max)
+    {
+        const std::size_t tail = idx_.tail.load(std::memory_order_relaxed);
+        const std::size_t avail = available(tail, max);
+        const std::size_t count = max < avail ? max : avail;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            fn(std::move(buf_[(tail + i) & mask_]));
+        }
+        if (count) idx_.tail.store((tail + count) & mask_, std::memory_order_release);
+        return count;
+    }
+
+    // Span flavour of pop_bulk: moves up to max elements into out.
+    std::size_t pop_bulk(T* out, std::size_t max)
+    {
+        return pop_bulk([&out](T&& v) { *out++ = std::move(v); }, max);
+    }
+
+    // Snapshot check, safe from either side; used by wait policies.
+    bool empty() const
+    {
+        return idx_.head.load(std::memory_order_acquire) == idx_.tail.load(std::memory_order_acquire);
+    }
+
+    // Occupancy as seen at one instant; only exact on the consumer side.
+    std::size_t size_approx() const
+    {
+        return (idx_.head.load(std::memory_order_acquire) - idx_.tail.load(std::memory_order_relaxed)) & mask_;
+    }
+
+private:
+    static constexpr std::size_t mask_ = CapacityPow2 - 1;
+    static constexpr bool cached_ = Layout == QueueLayout::CacheAligned;
+
+    // Producer side: free slots ahead of head, refreshing the cached tail
+    // only when it cannot satisfy want.
+    std::size_t free_slots(std::size_t head, std::size_t want)
+    {
+        if constexpr (cached_)
+        {
+            std::size_t free = (idx_.cachedTail - head - 1) & mask_;
+            if (free >= want) return free;
+            idx_.cachedTail = idx_.tail.load(std::memory_order_acquire);
+            return (idx_.cachedTail - head - 1) & mask_;
+        }
+        else
+        {
+            return (idx_.tail.load(std::memory_order_acquire) - head - 1) & mask_;
+        }
+    }
+
+    // Consumer side: filled slots from tail, refreshing the cached head
+    // only when it cannot satisfy want.
+    std::size_t available(std::size_t tail, std::size_t want)
+    {
+        if constexpr (cached_)
+        {
+            std::size_t avail = (idx_.cachedHead - tail) & mask_;
+            if (avail >= want) return avail;
+            idx_.cachedHead = idx_.head.load(std::memory_order_acquire);
+            return (idx_.cachedHead - tail) & mask_;
+        }
+        else
+        {
+            return (idx_.head.load(std::memory_order_acquire) - tail) & mask_;
+        }
+    }
+
+    detail::SPSCIndices<Layout> idx_;
+    alignas(cached_ ? kCacheLineSize : alignof(T)) std::array<T, CapacityPow2> buf_{};
+};
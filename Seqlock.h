@@ -0,0 +1,83 @@
+#pragma once
+#include "Platform.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+//
+// Single-writer, many-reader snapshot of a trivially copyable value.
+//
+// The writer bumps the sequence to odd, copies the value in and bumps it
+// back to even. Readers copy the value out and retry only if the
+// sequence was odd or changed underneath them, so reads never block the
+// writer and never take a lock. The value is held as relaxed atomic
+// words, which keeps the racing copies well defined.
+//
+template <typename T>
+class Seqlock
+{
+    static_assert(std::is_trivially_copyable_v<T>, "Seqlock copies T as raw words.");
+
+public:
+    Seqlock() : Seqlock(T{}) {}
+
+    explicit Seqlock(const T& initial)
+    {
+        store_words(initial);
+    }
+
+    // Writer side (one thread only).
+    void publish(const T& v)
+    {
+        const uint64_t s = seq_.load(std::memory_order_relaxed);
+        seq_.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        store_words(v);
+        seq_.store(s + 2, std::memory_order_release);
+    }
+
+    // One attempt; false if it overlapped a publish.
+    bool try_read(T& out, uint64_t* version = nullptr) const
+    {
+        const uint64_t s1 = seq_.load(std::memory_order_acquire);
+        if (s1 & 1) return false;
+        load_words(out);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seq_.load(std::memory_order_relaxed) != s1) return false;
+        if (version) *version = s1 / 2;
+        return true;
+    }
+
+    // Consistent copy; spins only while a publish is in flight.
+    T read(uint64_t* version = nullptr) const
+    {
+        T out;
+        while (!try_read(out, version)) detail::cpu_relax();
+        return out;
+    }
+
+    // Number of publishes so far.
+    uint64_t version() const { return seq_.load(std::memory_order_acquire) / 2; }
+
+private:
+    static constexpr size_t kWords = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    void store_words(const T& v)
+    {
+        uint64_t tmp[kWords]{};
+        std::memcpy(tmp, &v, sizeof(T));
+        for (size_t i = 0; i < kWords; ++i) words_[i].store(tmp[i], std::memory_order_relaxed);
+    }
+
+    void load_words(T& out) const
+    {
+        uint64_t tmp[kWords];
+        for (size_t i = 0; i < kWords; ++i) tmp[i] = words_[i].load(std::memory_order_relaxed);
+        std::memcpy(&out, tmp, sizeof(T));
+    }
+
+    alignas(kCacheLineSize) std::atomic<uint64_t> seq_{0};
+    std::atomic<uint64_t> words_[kWords];
+};
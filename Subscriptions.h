@@ -0,0 +1,150 @@
+#pragma once
+#include "ParameterTraits.h"
+#include "ParameterSet.h"
+#include "ParameterTable.h"
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+//
+// What changed in one applied batch: the set of changed ids plus the
+// value each one had before the batch and the value it has now.
+// Parameters whose value ended up unchanged are not reported.
+//
+class ChangeSet
+{
+public:
+    ChangeSet(const ParameterSet& ids, const ParameterTable& before, const ParameterTable& after)
+        : ids_(ids), before_(before), after_(after)
+    {
+    }
+
+    const ParameterSet& ids() const { return ids_; }
+    bool contains(ParameterID id) const { return ids_.contains(id); }
+
+    const void* old_value(ParameterID id) const { return before_.get(id); }
+    const void* new_value(ParameterID id) const { return after_.get(id); }
+
+    template <typename Tag>
+    const Tag& old_value() const { return before_.get<Tag>(); }
+
+    template <typename Tag>
+    const Tag& new_value() const { return after_.get<Tag>(); }
+
+private:
+    const ParameterSet&   ids_;
+    const ParameterTable& before_;
+    const ParameterTable& after_;
+};
+
+//
+// Preallocated subscriber table. A subscriber names the parameters it
+// cares about and gets one callback per applied batch that touched any
+// of them. Nothing is allocated on the dispatch path.
+//
+// Callbacks run on the worker thread and should be short. Subscribe
+// and unsubscribe while the worker is stopped.
+//
+template <std::size_t MaxSubscribers = 32>
+class BasicSubscriptionTable
+{
+public:
+    using Callback = void (*)(void* ctx, const ChangeSet& changes);
+
+    static constexpr int kInvalid = -1;
+
+    // Returns a handle for unsubscribe(), or kInvalid when full.
+    int subscribe(const ParameterSet& interest, Callback fn, void* ctx = nullptr)
+    {
+        for (std::size_t i = 0; i < MaxSubscribers; ++i)
+        {
+            if (!entries_[i].fn)
+            {
+                entries_[i] = Entry{ interest, fn, ctx };
+                return static_cast<int>(i);
+            }
+        }
+        return kInvalid;
+    }
+
+    int subscribe(ParameterID id, Callback fn, void* ctx = nullptr)
+    {
+        ParameterSet interest;
+        interest.insert(id);
+        return subscribe(interest, fn, ctx);
+    }
+
+    template <typename Tag>
+    int subscribe(Callback fn, void* ctx = nullptr)
+    {
+        return subscribe(param_id<Tag>(), fn, ctx);
+    }
+
+    void unsubscribe(int handle)
+    {
+        if (handle >= 0 && static_cast<std::size_t>(handle) < MaxSubscribers) entries_[handle] = Entry{};
+    }
+
+    void dispatch(const ChangeSet& changes) const
+    {
+        for (auto const& e : entries_)
+        {
+            if (e.fn && intersects(e.interest, changes.ids())) e.fn(e.ctx, changes);
+        }
+    }
+
+private:
+    struct Entry
+    {
+        ParameterSet interest;
+        Callback     fn  = nullptr;
+        void*        ctx = nullptr;
+    };
+
+    static bool intersects(const ParameterSet& a, const ParameterSet& b)
+    {
+        for (std::size_t w = 0; w < ParameterSet::kWords; ++w)
+            if (a.words()[w] & b.words()[w]) return true;
+        return false;
+    }
+
+    std::array<Entry, MaxSubscribers> entries_{};
+};
+
+using SubscriptionTable = BasicSubscriptionTable<>;
+
+//
+// Worker-side bookkeeping: remembers each parameter's value from before
+// its first write in the batch, then reports the ones that really
+// changed.
+//
+class ChangeTracker
+{
+public:
+    // Call before writing id into table.
+    void before_write(const ParameterTable& table, ParameterID id)
+    {
+        if (touched_.contains(id)) return;
+        touched_.insert(id);
+        before_.set(id, table.get(id));
+    }
+
+    bool empty() const { return touched_.empty(); }
+
+    template <std::size_t N>
+    void dispatch(const ParameterTable& table, const BasicSubscriptionTable<N>& subs)
+    {
+        ParameterSet changed;
+        touched_.for_each([&](ParameterID id)
+        {
+            const Handler& h = registry[static_cast<std::size_t>(id)];
+            if (std::memcmp(before_.get(id), table.get(id), h.size) != 0) changed.insert(id);
+        });
+        if (!changed.empty()) subs.dispatch(ChangeSet(changed, before_, table));
+        touched_.clear();
+    }
+
+private:
+    ParameterSet   touched_;
+    ParameterTable before_;
+};
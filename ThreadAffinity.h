@@ -0,0 +1,147 @@
+#pragma once
+#include <cstddef>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+//
+// Where a worker thread should run. cpu pins it to one CPU; otherwise
+// numa_node pins it to all CPUs of that node. Both -1 leaves the
+// scheduler alone. Linux only; elsewhere placement is a no-op.
+//
+struct ThreadPlacement
+{
+    int cpu       = -1;
+    int numa_node = -1;
+};
+
+enum class PlacementSpread
+{
+    None,
+    Cpus,    // index i -> i-th online CPU
+    Nodes    // index i -> i-th NUMA node
+};
+
+namespace detail
+{
+// Parse a sysfs list such as "0-3,8,10-11".
+inline std::vector<int> read_cpu_list(const char* path)
+{
+    std::vector<int> out;
+    std::FILE* f = std::fopen(path, "r");
+    if (!f) return out;
+    int lo, hi;
+    while (std::fscanf(f, "%d", &lo) == 1)
+    {
+        hi = lo;
+        int c = std::fgetc(f);
+        if (c == '-')
+        {
+            if (std::fscanf(f, "%d", &hi) != 1) break;
+            c = std::fgetc(f);
+        }
+        for (int i = lo; i <= hi; ++i) out.push_back(i);
+        if (c != ',') break;
+    }
+    std::fclose(f);
+    return out;
+}
+
+inline std::vector<int> online_cpus()
+{
+    auto cpus = read_cpu_list("/sys/devices/system/cpu/online");
+    if (cpus.empty())
+    {
+        for (unsigned i = 0; i < std::thread::hardware_concurrency(); ++i) cpus.push_back(static_cast<int>(i));
+    }
+    return cpus;
+}
+
+inline std::vector<int> numa_nodes()
+{
+    auto nodes = read_cpu_list("/sys/devices/system/node/online");
+    if (nodes.empty()) nodes.push_back(0);
+    return nodes;
+}
+
+inline std::vector<int> node_cpus(int node)
+{
+    char path[64];
+    std::snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+    return read_cpu_list(path);
+}
+
+// Apply placement to the calling thread. Returns false if it was
+// requested but could not be applied.
+inline bool apply_placement(const ThreadPlacement& p)
+{
+#if defined(__linux__)
+    std::vector<int> cpus;
+    if (p.cpu >= 0) cpus.push_back(p.cpu);
+    else if (p.numa_node >= 0) cpus = node_cpus(p.numa_node);
+    else return true;
+    if (cpus.empty()) return false;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int c : cpus)
+    {
+        if (c < CPU_SETSIZE) CPU_SET(c, &set);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    return p.cpu < 0 && p.numa_node < 0;
+#endif
+}
+
+// Switch the calling thread to SCHED_FIFO at priority (1-99); 0 leaves
+// its policy alone. Returns false if it was requested but refused
+// (needs CAP_SYS_NICE or an RLIMIT_RTPRIO of at least priority).
+inline bool apply_fifo_priority(int priority)
+{
+    if (priority <= 0) return true;
+#if defined(__linux__)
+    sched_param sp{};
+    sp.sched_priority = priority;
+    return pthread_setschedparam(pthread_self(), SCHED_FIFO, &sp) == 0;
+#else
+    return false;
+#endif
+}
+
+// Run fn on a short-lived thread with placement applied, so memory it
+// first touches is allocated on that thread's NUMA node.
+template <typename Fn>
+void run_placed(const ThreadPlacement& p, Fn&& fn)
+{
+    if (p.cpu < 0 && p.numa_node < 0)
+    {
+        fn();
+        return;
+    }
+    std::thread t([&] { apply_placement(p); fn(); });
+    t.join();
+}
+}
+
+// Placement for the index-th of a set of threads.
+inline ThreadPlacement spread_placement(std::size_t index, PlacementSpread how)
+{
+    ThreadPlacement p;
+    if (how == PlacementSpread::Cpus)
+    {
+        const auto cpus = detail::online_cpus();
+        if (!cpus.empty()) p.cpu = cpus[index % cpus.size()];
+    }
+    else if (how == PlacementSpread::Nodes)
+    {
+        const auto nodes = detail::numa_nodes();
+        p.numa_node = nodes[index % nodes.size()];
+    }
+    return p;
+}
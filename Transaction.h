@@ -0,0 +1,131 @@
+#pragma once
+#include "ParameterTraits.h"
+#include "ParamMessage.h"
+#include "ParameterSet.h"
+#include "ParameterTable.h"
+#include <array>
+#include <cstddef>
+
+//
+// A group of updates applied all-or-nothing.
+//
+// On the queue a transaction is a TxnBegin marker carrying the update
+// count, followed by that many SetParam messages. The whole run is
+// pushed with one try_push_all, so it is contiguous even on an MPSC
+// queue. The worker stages the updates, validates every one of them and
+// then the cross-parameter rules against the would-be state, and writes
+// them in one go; the snapshot is only published once the group is
+// complete, so readers never see half of it.
+//
+template <std::size_t MaxUpdates = 8>
+class Transaction
+{
+    static_assert(MaxUpdates <= 0xFFFF, "Update count travels as uint16.");
+
+public:
+    static constexpr std::size_t capacity = MaxUpdates;
+
+    // Returns false once the transaction is full.
+    template <typename Tag>
+    bool set(const Tag& value)
+    {
+        if (count_ == MaxUpdates) return false;
+        msgs_[1 + count_++] = Msg{ SetParam<Tag>{ value } };
+        msgs_[0] = Msg{ TxnBegin{ static_cast<uint16_t>(count_) } };
+        return true;
+    }
+
+    std::size_t updates() const { return count_; }
+
+    // The run of messages to enqueue (marker included).
+    const Msg* data() const { return msgs_.data(); }
+    Msg* data() { return msgs_.data(); }
+    std::size_t size() const { return count_ ? count_ + 1 : 0; }
+
+private:
+    std::array<Msg, MaxUpdates + 1> msgs_{};
+    std::size_t count_ = 0;
+};
+
+//
+// What the table would look like if the pending updates were applied:
+// staged values where there are any, the current table elsewhere.
+//
+class TxnView
+{
+public:
+    using Staged = std::array<const void*, registryCount>;
+
+    TxnView(const ParameterTable& table, const Staged& staged) : table_(table), staged_(staged) {}
+
+    bool touched(ParameterID id) const { return staged_[static_cast<std::size_t>(id)] != nullptr; }
+
+    const void* get(ParameterID id) const
+    {
+        const void* s = staged_[static_cast<std::size_t>(id)];
+        return s ? s : table_.get(id);
+    }
+
+    template <typename Tag>
+    const Tag& get() const { return *static_cast<const Tag*>(get(param_id<Tag>())); }
+
+    // Value before the update.
+    template <typename Tag>
+    const Tag& current() const { return table_.get<Tag>(); }
+
+private:
+    const ParameterTable& table_;
+    const Staged&         staged_;
+};
+
+//
+// Pluggable cross-parameter invariants, checked by the worker for every
+// transaction and for every standalone update. A rule returns false to
+// reject. Preallocated like the subscription table; add rules while
+// the worker is stopped.
+//
+// reads names the parameters a rule looks at (all of them unless
+// given); a ParamPool needs it to keep the rules on the shard that owns
+// those parameters.
+//
+template <std::size_t MaxRules = 16>
+class BasicCrossRuleTable
+{
+public:
+    using Rule = bool (*)(void* ctx, const TxnView& view);
+
+    bool add(Rule fn, void* ctx = nullptr, const ParameterSet& reads = ParameterSet::all())
+    {
+        if (count_ == MaxRules) return false;
+        rules_[count_++] = Entry{ fn, ctx };
+        reads.for_each([this](ParameterID id) { reads_.insert(id); });
+        return true;
+    }
+
+    // Every parameter any rule reads.
+    const ParameterSet& reads() const { return reads_; }
+
+    bool check(const TxnView& view) const
+    {
+        for (std::size_t i = 0; i < count_; ++i)
+        {
+            if (!rules_[i].fn(rules_[i].ctx, view)) return false;
+        }
+        return true;
+    }
+
+    bool empty() const { return count_ == 0; }
+
+private:
+    struct Entry
+    {
+        Rule  fn  = nullptr;
+        void* ctx = nullptr;
+    };
+
+    std::array<Entry, MaxRules> rules_{};
+    std::size_t count_ = 0;
+    ParameterSet reads_;
+};
+
+using CrossRuleTable = BasicCrossRuleTable<>;
@@ -0,0 +1,153 @@
+#pragma once
+#include "Platform.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#if !defined(__cpp_lib_atomic_wait) && defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+//
+// Wait policies decide what a consumer does while its queue is empty.
+//
+// Every policy has the same two-call interface:
+//
+//   wait(ready)  - consumer side; returns once ready() is true.
+//   notify()     - producer side; called after publishing new data.
+//
+// Only SpinBlockWait actually needs notify(); the others keep it as an
+// empty inline so callers do not care which policy they are using.
+//
+
+// Burn the core, lowest latency. Only for a dedicated, isolated CPU.
+struct BusySpinWait
+{
+    template <typename Ready>
+    void wait(Ready&& ready)
+    {
+        while (!ready()) detail::cpu_relax();
+    }
+
+    void notify() {}
+};
+
+// Spin for a while, then give the core back to the scheduler between polls.
+template <unsigned SpinCount = 1024>
+struct SpinYieldWait
+{
+    template <typename Ready>
+    void wait(Ready&& ready)
+    {
+        for (unsigned i = 0; i < SpinCount; ++i)
+        {
+            if (ready()) return;
+            detail::cpu_relax();
+        }
+        while (!ready()) std::this_thread::yield();
+    }
+
+    void notify() {}
+};
+
+//
+// Spin for a while, then park the consumer on a futex (std::atomic::wait
+// when the library has it). The producer only pays for a syscall when
+// the consumer is actually parked.
+//
+template <unsigned SpinCount = 1024>
+class SpinBlockWait
+{
+public:
+    template <typename Ready>
+    void wait(Ready&& ready)
+    {
+        for (unsigned i = 0; i < SpinCount; ++i)
+        {
+            if (ready()) return;
+            detail::cpu_relax();
+        }
+
+        while (true)
+        {
+            parked_.store(1, std::memory_order_relaxed);
+            // Pairs with the fence in notify(): either we see the new
+            // data here or the producer sees parked_ == 1.
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (ready()) break;
+            park();
+        }
+        parked_.store(0, std::memory_order_relaxed);
+    }
+
+    void notify()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (parked_.load(std::memory_order_relaxed) && parked_.exchange(0, std::memory_order_relaxed))
+        {
+            wake();
+        }
+    }
+
+private:
+    // Sleeps only while parked_ is still 1, so a notify() that raced
+    // ahead of us turns this into a no-op.
+    void park()
+    {
+#if defined(__cpp_lib_atomic_wait)
+        parked_.wait(1, std::memory_order_relaxed);
+#elif defined(__linux__)
+        syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&parked_), FUTEX_WAIT_PRIVATE, 1, nullptr, nullptr, 0);
+#else
+        std::this_thread::yield();
+#endif
+    }
+
+    void wake()
+    {
+#if defined(__cpp_lib_atomic_wait)
+        parked_.notify_one();
+#elif defined(__linux__)
+        syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&parked_), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#endif
+    }
+
+    static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t), "futex needs a plain 32-bit word");
+    std::atomic<std::uint32_t> parked_{0};
+};
+
+// The original fixed sleep-poll, kept as a baseline.
+template <unsigned SleepMicros = 50>
+struct SleepWait
+{
+    template <typename Ready>
+    void wait(Ready&& ready)
+    {
+        while (!ready()) std::this_thread::sleep_for(std::chrono::microseconds(SleepMicros));
+    }
+
+    void notify() {}
+};
+
+//
+// Deployment default, chosen with PARAMETER_TRAITS_WAIT_POLICY
+// (0 = busy spin, 1 = spin/yield, 2 = spin/block, 3 = sleep).
+//
+#ifndef PARAMETER_TRAITS_WAIT_POLICY
+#define PARAMETER_TRAITS_WAIT_POLICY 2
+#endif
+
+#if PARAMETER_TRAITS_WAIT_POLICY == 0
+using DefaultWaitPolicy = BusySpinWait;
+#elif PARAMETER_TRAITS_WAIT_POLICY == 1
+using DefaultWaitPolicy = SpinYieldWait<>;
+#elif PARAMETER_TRAITS_WAIT_POLICY == 2
+using DefaultWaitPolicy = SpinBlockWait<>;
+#elif PARAMETER_TRAITS_WAIT_POLICY == 3
+using DefaultWaitPolicy = SleepWait<>;
+#else
+#error "Unknown PARAMETER_TRAITS_WAIT_POLICY"
+#endif
@@ -0,0 +1,204 @@
+#pragma once
+#include "ParameterTraits.h"
+#include "ParameterTable.h"
+#include <cstddef>
+#include <cstdint>
+
+//
+// Binary wire format for shipping parameters between nodes.
+//
+// Record: [uint16 ParameterID][UnderlyingType], little-endian, as written
+//         by ParameterTraits<T>::encode_binary / Handler::encode_binary.
+//
+// Frame:  [uint32 magic "PTBF"][uint16 version][uint16 record count]
+//         followed by that many records, back to back. A whole
+//         ParameterTable fits in kTableFrameSize bytes, so senders can
+//         use a fixed buffer and receivers can decode straight out of
+//         the datagram without copying it first.
+//
+constexpr uint32_t kFrameMagic      = 0x46425450u;  // "PTBF" read as little-endian
+constexpr uint16_t kFrameVersion    = 1;
+constexpr size_t   kFrameHeaderSize = 8;
+
+namespace detail
+{
+constexpr size_t table_frame_size()
+{
+    size_t n = kFrameHeaderSize;
+    for (auto const& h : registry) n += h.wire_size;
+    return n;
+}
+}
+
+static constexpr size_t kTableFrameSize = detail::table_frame_size();
+
+//
+// Zero-copy view of one record inside a received buffer.
+//
+class BinaryRecordView
+{
+public:
+    BinaryRecordView(const unsigned char* data, size_t n) : data_(data), n_(n) {}
+
+    bool complete() const
+    {
+        const Handler* h = handler();
+        return h && n_ >= h->wire_size;
+    }
+
+    ParameterID id() const
+    {
+        return static_cast<ParameterID>(detail::load_le<uint16_t>(data_));
+    }
+
+    // nullptr for a truncated record or an id this build does not know.
+    const Handler* handler() const
+    {
+        return n_ >= detail::kRecordHeaderSize ? find_by_id(id()) : nullptr;
+    }
+
+    size_t size() const
+    {
+        return complete() ? handler()->wire_size : 0;
+    }
+
+    // Decode into storage for the registered type (validates).
+    bool decode(void* out) const
+    {
+        const Handler* h = handler();
+        return h && h->decode_binary(data_, n_, out) != 0;
+    }
+
+    template <typename Tag>
+    bool get(Tag& out) const
+    {
+        return param_decode_binary(data_, n_, out) != 0;
+    }
+
+    const unsigned char* data() const { return data_; }
+
+private:
+    const unsigned char* data_;
+    size_t               n_;
+};
+
+//
+// Zero-copy view of a frame. valid() checks the header; for_each walks
+// the records in place.
+//
+class BinaryFrameView
+{
+public:
+    BinaryFrameView(const unsigned char* data, size_t n) : data_(data), n_(n) {}
+
+    bool valid() const
+    {
+        return n_ >= kFrameHeaderSize
+            && detail::load_le<uint32_t>(data_) == kFrameMagic
+            && detail::load_le<uint16_t>(data_ + 4) == kFrameVersion;
+    }
+
+    uint16_t count() const { return detail::load_le<uint16_t>(data_ + 6); }
+
+    //
+    // Calls fn(const BinaryRecordView&) for each record. Returns false if
+    // the header is bad or a record is truncated or unknown; records
+    // before that point have already been visited.
+    //
+    template <typename Fn>
+    bool for_each(Fn&& fn) const
+    {
+        if (!valid()) return false;
+
+        size_t offset = kFrameHeaderSize;
+        for (uint16_t i = 0; i < count(); ++i)
+        {
+            BinaryRecordView rec(data_ + offset, n_ - offset);
+            const size_t size = rec.size();
+            if (size == 0) return false;
+            fn(rec);
+            offset += size;
+        }
+        return true;
+    }
+
+private:
+    const unsigned char* data_;
+    size_t               n_;
+};
+
+namespace detail
+{
+inline void store_frame_header(uint16_t records, unsigned char* out)
+{
+    store_le(kFrameMagic, out);
+    store_le(kFrameVersion, out + 4);
+    store_le(records, out + 6);
+}
+}
+
+//
+// Encode every parameter of table into one frame. Returns the frame
+// size (kTableFrameSize), or 0 if out is too small.
+//
+inline size_t encode_table(const ParameterTable& table, unsigned char* out, size_t n)
+{
+    if (n < kTableFrameSize) return 0;
+
+    detail::store_frame_header(static_cast<uint16_t>(registryCount), out);
+
+    size_t used = kFrameHeaderSize;
+    for (auto const& h : registry)
+    {
+        used += h.encode_binary(table.get(h.id), out + used, n - used);
+    }
+    return used;
+}
+
+//
+// Encode only the parameters in ids, e.g. table.changed_since(gen),
+// into one frame; decode_table applies it like a full one. Any set fits
+// in kTableFrameSize. Returns the frame size, or 0 if out is too small.
+//
+inline size_t encode_set(const ParameterTable& table, const ParameterSet& ids, unsigned char* out, size_t n)
+{
+    if (n < kFrameHeaderSize) return 0;
+
+    size_t used = kFrameHeaderSize;
+    uint16_t records = 0;
+    bool ok = true;
+    ids.for_each([&](ParameterID id)
+    {
+        const Handler& h = registry[static_cast<size_t>(id)];
+        const size_t w = ok ? h.encode_binary(table.get(id), out + used, n - used) : 0;
+        ok = w != 0;
+        used += w;
+        ++records;
+    });
+    if (!ok) return 0;
+    detail::store_frame_header(records, out);
+    return used;
+}
+
+//
+// Apply every record of a frame to table. Records that fail validation
+// are skipped and counted in *rejected (if given). Returns false on a
+// malformed frame, which is checked in full first so that none of it
+// is applied.
+//
+inline bool decode_table(const unsigned char* in, size_t n, ParameterTable& table, size_t* rejected = nullptr)
+{
+    if (rejected) *rejected = 0;
+    const BinaryFrameView frame(in, n);
+    if (!frame.for_each([](const BinaryRecordView&) {})) return false;
+
+    alignas(kMaxParameterAlign) unsigned char value[kMaxParameterSize];
+    size_t bad = 0;
+    frame.for_each([&](const BinaryRecordView& rec)
+    {
+        if (rec.decode(value)) table.set(rec.id(), value);
+        else ++bad;
+    });
+    if (rejected) *rejected = bad;
+    return true;
+}
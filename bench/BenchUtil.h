@@ -0,0 +1,29 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+//
+// Small helpers shared by the stand-alone benchmarks.
+//
+namespace bench
+{
+using Clock = std::chrono::steady_clock;
+
+inline std::uint64_t now_ns()
+{
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count());
+}
+
+// Keep the optimiser from discarding a computed value.
+template <typename T>
+inline void do_not_optimize(const T& v)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(v) : "memory");
+#else
+    static volatile const T* sink;
+    sink = &v;
+#endif
+}
+}
@@ -0,0 +1,86 @@
+#include "MPSCQueue.h"
+#include "SPSCQueue.h"
+#include "BenchUtil.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//
+// Producer scaling: 1..16 producer threads feeding one consumer, through
+// MPSCQueue versus the current workaround of an SPSCQueue with a mutex
+// around try_push. Each run moves the same total number of messages.
+//
+namespace
+{
+constexpr std::uint64_t kMessages = 2'000'000;
+constexpr std::size_t   kCapacity = 1024;
+
+struct LockedSPSC
+{
+    SPSCQueue<std::uint64_t, kCapacity, QueueLayout::CacheAligned> q;
+    std::mutex m;
+
+    bool try_push(std::uint64_t v)
+    {
+        std::lock_guard<std::mutex> lock(m);
+        return q.try_push(v);
+    }
+
+    template <typename Fn>
+    std::size_t pop_bulk(Fn&& fn, std::size_t max) { return q.pop_bulk(fn, max); }
+};
+
+template <typename Queue>
+double run(unsigned producers)
+{
+    static Queue q;
+    const std::uint64_t perProducer = kMessages / producers;
+    const std::uint64_t total = perProducer * producers;
+    std::uint64_t sum = 0;
+
+    auto start = bench::Clock::now();
+    std::thread consumer([&]
+    {
+        for (std::uint64_t received = 0; received < total;)
+        {
+            std::size_t n = q.pop_bulk([&](std::uint64_t&& v) { sum += v; }, 64);
+            if (n == 0) std::this_thread::yield();
+            received += n;
+        }
+    });
+
+    std::vector<std::thread> pool;
+    for (unsigned p = 0; p < producers; ++p)
+    {
+        pool.emplace_back([&]
+        {
+            for (std::uint64_t i = 0; i < perProducer;)
+            {
+                if (q.try_push(i)) ++i;
+                else std::this_thread::yield();
+            }
+        });
+    }
+    for (auto& t : pool) t.join();
+    consumer.join();
+
+    std::chrono::duration<double> secs = bench::Clock::now() - start;
+    bench::do_not_optimize(sum);
+    return total / secs.count();
+}
+}
+
+int main()
+{
+    std::printf("%9s %16s %16s\n", "producers", "mpsc msgs/sec", "mutex+spsc");
+    for (unsigned p : {1u, 2u, 4u, 8u, 16u})
+    {
+        const double mpsc = run<MPSCQueue<std::uint64_t, kCapacity>>(p);
+        const double locked = run<LockedSPSC>(p);
+        std::printf("%9u %16.0f %16.0f\n", p, mpsc, locked);
+    }
+    return 0;
+}
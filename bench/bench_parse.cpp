@@ -0,0 +1,98 @@
+#include "ParameterTraits.h"
+#include "BenchUtil.h"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//
+// ns/parse for FanDutyCycle values through the NUL-terminated entry
+// point (strlen + from_chars, strtof fallback) versus the length-aware
+// string_view overload, with plain strtof as a reference. Also ns per
+// serialize for the to_chars formatter against snprintf("%.2f").
+//
+namespace
+{
+constexpr std::size_t kValues = 1 << 16;
+constexpr int         kRounds = 32;
+
+std::vector<std::string> make_inputs()
+{
+    std::vector<std::string> v;
+    v.reserve(kValues);
+    std::srand(42);
+    char buf[32];
+    for (std::size_t i = 0; i < kValues; ++i)
+    {
+        std::snprintf(buf, sizeof(buf), "%.2f", (std::rand() % 10000) / 100.0);
+        v.emplace_back(buf);
+    }
+    return v;
+}
+
+template <typename Fn>
+void report(const char* name, Fn&& fn)
+{
+    std::size_t ok = 0;
+    auto start = bench::now_ns();
+    for (int r = 0; r < kRounds; ++r) ok += fn();
+    auto elapsed = bench::now_ns() - start;
+    bench::do_not_optimize(ok);
+    std::printf("%-28s %8.2f ns/op\n", name, double(elapsed) / (double(kValues) * kRounds));
+}
+}
+
+int main()
+{
+    const auto inputs = make_inputs();
+    std::vector<std::string_view> views(inputs.begin(), inputs.end());
+
+    report("param_parse(const char*)", [&]
+    {
+        std::size_t ok = 0;
+        FanDutyCycle f{};
+        for (auto const& s : inputs) ok += param_parse(s.c_str(), f);
+        return ok;
+    });
+
+    report("param_parse(string_view)", [&]
+    {
+        std::size_t ok = 0;
+        FanDutyCycle f{};
+        for (auto sv : views) ok += param_parse(sv, f);
+        return ok;
+    });
+
+    report("strtof reference", [&]
+    {
+        std::size_t ok = 0;
+        for (auto const& s : inputs)
+        {
+            char* end{};
+            float v = std::strtof(s.c_str(), &end);
+            ok += end != s.c_str() && v >= 0.0f && v <= 100.0f;
+        }
+        return ok;
+    });
+
+    std::vector<FanDutyCycle> values(kValues);
+    for (std::size_t i = 0; i < kValues; ++i) param_parse(views[i], values[i]);
+
+    report("param_serialize", [&]
+    {
+        std::size_t bytes = 0;
+        char buf[32];
+        for (auto const& v : values) bytes += param_serialize(v, buf, sizeof(buf));
+        return bytes;
+    });
+
+    report("snprintf(\"%.2f\") reference", [&]
+    {
+        std::size_t bytes = 0;
+        char buf[32];
+        for (auto const& v : values) bytes += detail::safe_snp("%.2f", v.percent, buf, sizeof(buf));
+        return bytes;
+    });
+    return 0;
+}
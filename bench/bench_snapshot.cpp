@@ -0,0 +1,74 @@
+#include "ParameterTable.h"
+#include "Seqlock.h"
+#include "BenchUtil.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+//
+// Reader throughput of Seqlock<ParameterTable> while a writer keeps
+// publishing new versions (as ParamWorker does after every batch).
+// Reports consistent reads/sec for the reader threads combined and how
+// often a read had to retry.
+//
+namespace
+{
+constexpr auto kDuration = std::chrono::milliseconds(500);
+
+void run_readers(unsigned readers)
+{
+    Seqlock<ParameterTable> snap;
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> reads{0}, retries{0}, publishes{0};
+
+    std::thread writer([&]
+    {
+        ParameterTable t;
+        uint64_t n = 0;
+        while (!stop.load(std::memory_order_relaxed))
+        {
+            t.set(FanDutyCycle{ static_cast<float>(n % 100) });
+            snap.publish(t);
+            ++n;
+        }
+        publishes = n;
+    });
+
+    std::vector<std::thread> pool;
+    for (unsigned r = 0; r < readers; ++r)
+    {
+        pool.emplace_back([&]
+        {
+            uint64_t ok = 0, again = 0;
+            ParameterTable copy;
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                if (snap.try_read(copy)) ++ok;
+                else ++again;
+            }
+            bench::do_not_optimize(copy);
+            reads += ok;
+            retries += again;
+        });
+    }
+
+    std::this_thread::sleep_for(kDuration);
+    stop = true;
+    writer.join();
+    for (auto& t : pool) t.join();
+
+    const double secs = std::chrono::duration<double>(kDuration).count();
+    const double total = double(reads + retries);
+    std::printf("%7u %16.0f %12.2f%% %16.0f\n", readers, reads / secs,
+                total ? 100.0 * retries / total : 0.0, publishes / secs);
+}
+}
+
+int main()
+{
+    std::printf("%7s %16s %13s %16s\n", "readers", "reads/sec", "retry", "publishes/sec");
+    for (unsigned r : {1u, 2u, 4u, 8u}) run_readers(r);
+    return 0;
+}
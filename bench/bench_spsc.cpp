@@ -0,0 +1,106 @@
+#include "SPSCQueue.h"
+#include "BenchUtil.h"
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+
+//
+// Producer/consumer throughput of SPSCQueue: one element per
+// try_push/try_pop versus runs published with try_push_n/pop_bulk, for
+// both index layouts.
+// Both sides yield when they make no progress so the numbers stay
+// meaningful when producer and consumer share a core.
+//
+namespace
+{
+constexpr std::size_t   kCapacity = 1024;
+constexpr std::uint64_t kMessages = 2'000'000;
+
+template <QueueLayout Layout>
+using Queue = SPSCQueue<std::uint64_t, kCapacity, Layout>;
+
+template <QueueLayout Layout>
+double run_single()
+{
+    static Queue<Layout> q;
+    std::uint64_t sum = 0;
+    auto start = bench::Clock::now();
+
+    std::thread consumer([&]
+    {
+        for (std::uint64_t received = 0; received < kMessages;)
+        {
+            if (auto v = q.try_pop())
+            {
+                sum += *v;
+                ++received;
+            }
+            else std::this_thread::yield();
+        }
+    });
+
+    for (std::uint64_t i = 0; i < kMessages;)
+    {
+        if (q.try_push(i)) ++i;
+        else std::this_thread::yield();
+    }
+    consumer.join();
+
+    std::chrono::duration<double> secs = bench::Clock::now() - start;
+    bench::do_not_optimize(sum);
+    return kMessages / secs.count();
+}
+
+template <QueueLayout Layout>
+double run_bulk(std::size_t batch)
+{
+    static Queue<Layout> q;
+    std::uint64_t sum = 0;
+    auto start = bench::Clock::now();
+
+    std::thread consumer([&]
+    {
+        for (std::uint64_t received = 0; received < kMessages;)
+        {
+            std::size_t n = q.pop_bulk([&](std::uint64_t&& v) { sum += v; }, batch);
+            if (n == 0) std::this_thread::yield();
+            received += n;
+        }
+    });
+
+    std::uint64_t staged[256];
+    for (std::uint64_t i = 0; i < kMessages;)
+    {
+        std::size_t n = kMessages - i < batch ? kMessages - i : batch;
+        for (std::size_t k = 0; k < n; ++k) staged[k] = i + k;
+        std::size_t pushed = q.try_push_n(staged, n);
+        if (pushed == 0) std::this_thread::yield();
+        i += pushed;
+    }
+    consumer.join();
+
+    std::chrono::duration<double> secs = bench::Clock::now() - start;
+    bench::do_not_optimize(sum);
+    return kMessages / secs.count();
+}
+
+template <QueueLayout Layout>
+void run_layout(const char* name)
+{
+    std::printf("%-14s %-24s %14.0f\n", name, "single try_push/try_pop", run_single<Layout>());
+    for (std::size_t batch : {8u, 32u, 64u, 256u})
+    {
+        char label[32];
+        std::snprintf(label, sizeof(label), "bulk batch=%zu", batch);
+        std::printf("%-14s %-24s %14.0f\n", name, label, run_bulk<Layout>(batch));
+    }
+}
+}
+
+int main()
+{
+    std::printf("%-14s %-24s %14s\n", "layout", "path", "msgs/sec");
+    run_layout<QueueLayout::Compact>("compact");
+    run_layout<QueueLayout::CacheAligned>("cache-aligned");
+    return 0;
+}
@@ -0,0 +1,67 @@
+#include "ParameterTraits.h"
+#include "ParameterTable.h"
+#include "ConfigLoader.h"
+#include "ParamStore.h"
+#include "BenchUtil.h"
+#include <cstdio>
+#include <string>
+
+//
+// Start-up cost of restoring a ParameterTable: replaying a journal of
+// kRecords applied values, opening a fresh snapshot with an empty
+// journal, and loading the same updates through the text config path.
+//
+int main(int argc, char** argv)
+{
+    constexpr std::size_t kRecords = 200'000;
+    const std::string dir = argc > 1 ? argv[1] : "/tmp";
+    const std::string snap = dir + "/bench_store.snap";
+    const std::string journal = dir + "/bench_store.journal";
+    const std::string text = dir + "/bench_store.cfg";
+    std::remove(snap.c_str());
+    std::remove(journal.c_str());
+
+    {
+        ParameterTable table;
+        ParamStore store(snap, journal, 0);
+        store.open(table);
+        std::FILE* cfg = std::fopen(text.c_str(), "w");
+        char buf[32];
+        for (std::size_t i = 0; i < kRecords; ++i)
+        {
+            const Handler& h = registry[i % registryCount];
+            const float v = float(i % 100);
+            store.append(h.id, &v);
+            h.serialize(&v, buf, sizeof(buf));
+            std::fprintf(cfg, "%s=%s\n", h.name, buf);
+            if (i % ParamStore::kBlockRecords == ParamStore::kBlockRecords - 1) store.commit(table);
+        }
+        std::fclose(cfg);
+    }
+
+    auto time = [](const char* name, auto&& fn)
+    {
+        ParameterTable table;
+        const auto start = bench::now_ns();
+        fn(table);
+        const auto elapsed = bench::now_ns() - start;
+        std::printf("%-24s %10.3f ms\n", name, double(elapsed) / 1e6);
+        return table;
+    };
+
+    time("journal replay", [&](ParameterTable& t) { ParamStore(snap, journal, 0).open(t); });
+    time("text config", [&](ParameterTable& t) { load_config_file(text.c_str(), t, [](auto&&...) {}); });
+
+    {
+        ParameterTable t;
+        ParamStore store(snap, journal, 0);
+        store.open(t);
+        store.checkpoint(t);
+    }
+    time("snapshot + empty journal", [&](ParameterTable& t) { ParamStore(snap, journal, 0).open(t); });
+
+    std::remove(snap.c_str());
+    std::remove(journal.c_str());
+    std::remove(text.c_str());
+    return 0;
+}
@@ -0,0 +1,344 @@
+#include "ParameterTraits.h"
+#include "ParamMessage.h"
+#include "ParameterTable.h"
+#include "ParamWorker.h"
+#include "Seqlock.h"
+#include "SPSCQueue.h"
+#include "WireFormat.h"
+#include "BenchUtil.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <variant>
+#include <vector>
+
+//
+// Regression suite for the pieces the parameter pipeline is built on.
+// Every case is timed by a self-contained harness and the results are
+// written as JSON, in the same layout Google Benchmark uses, so they
+// can be tracked across releases with the usual tooling:
+//
+//   bench_suite [--out=results.json] [--filter=substring]
+//
+// Each case runs with the iteration count doubled until one run takes
+// at least kMinRunNs, then kRepetitions more times; the median is
+// reported together with the minimum.
+//
+namespace
+{
+constexpr std::uint64_t kMinRunNs    = 50'000'000;
+constexpr int           kRepetitions = 5;
+
+struct Result
+{
+    std::string   name;
+    std::uint64_t iterations;
+    double        median_ns;
+    double        min_ns;
+};
+
+class Suite
+{
+public:
+    explicit Suite(std::string_view filter) : filter_(filter) {}
+
+    // fn(iterations) performs that many operations.
+    template <typename Fn>
+    void run(const char* name, Fn&& fn)
+    {
+        if (!filter_.empty() && std::string_view(name).find(filter_) == std::string_view::npos) return;
+
+        std::uint64_t iters = 1;
+        while (true)
+        {
+            const auto start = bench::now_ns();
+            fn(iters);
+            if (bench::now_ns() - start >= kMinRunNs || iters >= (std::uint64_t(1) << 40)) break;
+            iters *= 2;
+        }
+
+        std::vector<double> per_op;
+        for (int r = 0; r < kRepetitions; ++r)
+        {
+            const auto start = bench::now_ns();
+            fn(iters);
+            per_op.push_back(double(bench::now_ns() - start) / double(iters));
+        }
+        std::sort(per_op.begin(), per_op.end());
+        results_.push_back(Result{ name, iters, per_op[per_op.size() / 2], per_op.front() });
+        std::fprintf(stderr, "%-32s %10.2f ns/op\n", name, results_.back().median_ns);
+    }
+
+    void write_json(std::FILE* out) const
+    {
+        std::fprintf(out, "{\n  \"context\": {\n");
+        std::fprintf(out, "    \"executable\": \"bench_suite\",\n");
+        std::fprintf(out, "    \"num_cpus\": %u,\n", std::thread::hardware_concurrency());
+        std::fprintf(out, "    \"cache_line_size\": %zu,\n", kCacheLineSize);
+#if defined(NDEBUG)
+        std::fprintf(out, "    \"library_build_type\": \"release\"\n");
+#else
+        std::fprintf(out, "    \"library_build_type\": \"debug\"\n");
+#endif
+        std::fprintf(out, "  },\n  \"benchmarks\": [\n");
+        for (std::size_t i = 0; i < results_.size(); ++i)
+        {
+            auto const& r = results_[i];
+            std::fprintf(out,
+                         "    {\"name\": \"%s\", \"run_type\": \"aggregate\", \"aggregate_name\": \"median\", "
+                         "\"iterations\": %llu, \"real_time\": %.3f, \"min_time\": %.3f, \"time_unit\": \"ns\"}%s\n",
+                         r.name.c_str(), static_cast<unsigned long long>(r.iterations), r.median_ns, r.min_ns,
+                         i + 1 < results_.size() ? "," : "");
+        }
+        std::fprintf(out, "  ]\n}\n");
+    }
+
+private:
+    std::string_view    filter_;
+    std::vector<Result> results_;
+};
+
+// ------------------------
+// SPSCQueue
+// ------------------------
+using BenchQueue = SPSCQueue<Msg, 1024, QueueLayout::CacheAligned>;
+
+void spsc_throughput(std::uint64_t n)
+{
+    BenchQueue q;
+    std::thread consumer([&]
+    {
+        std::uint64_t seen = 0;
+        while (seen < n)
+        {
+            const auto got = q.pop_bulk([](Msg&& m) { bench::do_not_optimize(m); }, 64);
+            if (got == 0) std::this_thread::yield();
+            seen += got;
+        }
+    });
+    const Msg m{ SetParam<FanDutyCycle>{ FanDutyCycle{ 1.0f } } };
+    for (std::uint64_t i = 0; i < n; ++i)
+    {
+        while (!q.try_push(m)) std::this_thread::yield();
+    }
+    consumer.join();
+}
+
+// One iteration is a full round trip through two rings.
+void spsc_pingpong(std::uint64_t n)
+{
+    BenchQueue ping, pong;
+    std::thread echo([&]
+    {
+        for (std::uint64_t i = 0; i < n; ++i)
+        {
+            std::optional<Msg> m;
+            while (!(m = ping.try_pop())) std::this_thread::yield();
+            while (!pong.try_push(*m)) std::this_thread::yield();
+        }
+    });
+    const Msg m{ SetParam<FanDutyCycle>{ FanDutyCycle{ 1.0f } } };
+    for (std::uint64_t i = 0; i < n; ++i)
+    {
+        while (!ping.try_push(m)) std::this_thread::yield();
+        while (!pong.try_pop()) std::this_thread::yield();
+    }
+    echo.join();
+}
+
+// ------------------------
+// Dispatch
+// ------------------------
+// The std::variant message this repo started from, as the baseline the
+// Handler table replaced.
+using VariantMsg = std::variant<SetParam<TemperatureSetpoint>, SetParam<HighTemperatureAlarm>, SetParam<FanDutyCycle>>;
+
+template <typename T>
+std::vector<T> mixed_messages(std::size_t n)
+{
+    std::vector<T> v;
+    v.reserve(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const float x = float(i % 120);
+        switch (i % 3)
+        {
+        case 0: v.push_back(T{ SetParam<TemperatureSetpoint>{ { x } } }); break;
+        case 1: v.push_back(T{ SetParam<HighTemperatureAlarm>{ { x } } }); break;
+        default: v.push_back(T{ SetParam<FanDutyCycle>{ { x } } }); break;
+        }
+    }
+    return v;
+}
+
+constexpr std::size_t kMixed = 1024;
+
+// ------------------------
+// End to end
+// ------------------------
+// Post one update and wait until the worker's published snapshot shows
+// it: producer -> queue -> ParamWorker -> ParameterTable -> Seqlock.
+void end_to_end(std::uint64_t n)
+{
+    ParamQueue q;
+    ParameterTable table;
+    Seqlock<ParameterTable> snapshot;
+    WorkerConfig cfg;
+    cfg.snapshot = &snapshot;
+    ParamWorker<> worker(q, table, cfg);
+    worker.start();
+
+    for (std::uint64_t i = 0; i < n; ++i)
+    {
+        const auto before = snapshot.version();
+        const Msg m{ SetParam<FanDutyCycle>{ FanDutyCycle{ float(i % 100) } } };
+        while (!worker.try_post(m)) std::this_thread::yield();
+        while (snapshot.version() == before) std::this_thread::yield();
+    }
+
+    while (!worker.try_post(Msg{ Stop{} })) std::this_thread::yield();
+    worker.join();
+}
+}
+
+int main(int argc, char** argv)
+{
+    const char* out_path = nullptr;
+    std::string_view filter;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view arg(argv[i]);
+        if (arg.rfind("--out=", 0) == 0) out_path = argv[i] + 6;
+        else if (arg.rfind("--filter=", 0) == 0) filter = arg.substr(9);
+    }
+
+    Suite suite(filter);
+
+    suite.run("spsc/throughput", spsc_throughput);
+    suite.run("spsc/pingpong", spsc_pingpong);
+
+    {
+        const auto variants = mixed_messages<VariantMsg>(kMixed);
+        ParameterTable table;
+        suite.run("dispatch/std_visit", [&](std::uint64_t n)
+        {
+            for (std::uint64_t i = 0; i < n; ++i)
+            {
+                std::visit([&](auto const& s)
+                {
+                    using Tag = std::decay_t<decltype(s.value)>;
+                    if (param_validate(s.value)) table.set<Tag>(s.value);
+                }, variants[i & (kMixed - 1)]);
+            }
+            bench::do_not_optimize(table);
+        });
+
+        const auto msgs = mixed_messages<Msg>(kMixed);
+        suite.run("dispatch/handler_table", [&](std::uint64_t n)
+        {
+            for (std::uint64_t i = 0; i < n; ++i)
+            {
+                const Msg& m = msgs[i & (kMixed - 1)];
+                const Handler* h = find_by_id(m.id);
+                if (h && h->validate(m.payload)) table.set(m.id, m.payload);
+            }
+            bench::do_not_optimize(table);
+        });
+    }
+
+    {
+        std::vector<std::string> texts;
+        char buf[32];
+        for (std::size_t i = 0; i < kMixed; ++i)
+        {
+            std::snprintf(buf, sizeof(buf), "%.2f", double(i % 10000) / 100.0);
+            texts.emplace_back(buf);
+        }
+        suite.run("param_parse/string_view", [&](std::uint64_t n)
+        {
+            FanDutyCycle f{};
+            std::size_t ok = 0;
+            for (std::uint64_t i = 0; i < n; ++i) ok += param_parse(std::string_view(texts[i & (kMixed - 1)]), f);
+            bench::do_not_optimize(ok);
+        });
+
+        suite.run("param_serialize", [&](std::uint64_t n)
+        {
+            char out[32];
+            std::size_t bytes = 0;
+            for (std::uint64_t i = 0; i < n; ++i)
+                bytes += param_serialize(FanDutyCycle{ float(i & 1023) / 10.0f }, out, sizeof(out));
+            bench::do_not_optimize(bytes);
+        });
+    }
+
+    {
+        std::vector<std::string> names;
+        for (auto const& h : registry) names.emplace_back(h.name);
+        names.emplace_back("NoSuchParameter");
+        suite.run("find_by_name", [&](std::uint64_t n)
+        {
+            std::size_t found = 0;
+            for (std::uint64_t i = 0; i < n; ++i) found += find_by_name(names[i % names.size()]) != nullptr;
+            bench::do_not_optimize(found);
+        });
+    }
+
+    {
+        // Periodic telemetry export with one parameter changing between
+        // exports: the whole table versus only what changed.
+        ParameterTable table;
+        char text[512];
+        unsigned char frame[kTableFrameSize];
+        suite.run("export/full_text", [&](std::uint64_t n)
+        {
+            std::size_t bytes = 0;
+            for (std::uint64_t i = 0; i < n; ++i)
+            {
+                table.set(FanDutyCycle{ float(i % 100) });
+                bytes += serialize_all(table, text, sizeof(text));
+            }
+            bench::do_not_optimize(bytes);
+        });
+        suite.run("export/delta_text", [&](std::uint64_t n)
+        {
+            std::size_t bytes = 0;
+            std::uint64_t since = table.generation();
+            for (std::uint64_t i = 0; i < n; ++i)
+            {
+                table.set(FanDutyCycle{ float(i % 100) });
+                bytes += serialize_set(table, table.changed_since(since), text, sizeof(text));
+                since = table.generation();
+            }
+            bench::do_not_optimize(bytes);
+        });
+        suite.run("export/delta_binary", [&](std::uint64_t n)
+        {
+            std::size_t bytes = 0;
+            std::uint64_t since = table.generation();
+            for (std::uint64_t i = 0; i < n; ++i)
+            {
+                table.set(FanDutyCycle{ float(i % 100) });
+                bytes += encode_set(table, table.changed_since(since), frame, sizeof(frame));
+                since = table.generation();
+            }
+            bench::do_not_optimize(bytes);
+        });
+    }
+
+    suite.run("end_to_end/worker_roundtrip", end_to_end);
+
+    std::FILE* out = out_path ? std::fopen(out_path, "w") : stdout;
+    if (!out)
+    {
+        std::fprintf(stderr, "cannot open %s\n", out_path);
+        return 1;
+    }
+    suite.write_json(out);
+    if (out != stdout) std::fclose(out);
+    return 0;
+}
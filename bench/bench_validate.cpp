@@ -0,0 +1,41 @@
+#include "ParameterTraits.h"
+#include "BenchUtil.h"
+#include <cstdio>
+#include <random>
+#include <vector>
+
+//
+// ns/value for range-checking a large FanDutyCycle array one value at a
+// time through Handler::validate versus validate_bulk.
+//
+int main()
+{
+    constexpr std::size_t kValues = 1 << 18;
+    constexpr int         kRounds = 64;
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> dist(-10.0f, 110.0f);
+    std::vector<float> values(kValues);
+    for (auto& v : values) v = dist(rng);
+    std::vector<uint64_t> mask((kValues + 63) / 64);
+
+    const Handler& h = *find_by_id(ParameterID::FanDutyCycle);
+
+    std::size_t rejected = 0;
+    auto start = bench::now_ns();
+    for (int r = 0; r < kRounds; ++r)
+        for (std::size_t i = 0; i < kValues; ++i)
+            rejected += !h.validate(&values[i]);
+    auto scalar = bench::now_ns() - start;
+    bench::do_not_optimize(rejected);
+
+    start = bench::now_ns();
+    for (int r = 0; r < kRounds; ++r) rejected += validate_bulk<FanDutyCycle>(values.data(), kValues, mask.data());
+    auto bulk = bench::now_ns() - start;
+    bench::do_not_optimize(rejected);
+
+    const double n = double(kValues) * kRounds;
+    std::printf("%-24s %8.3f ns/value\n", "Handler::validate", scalar / n);
+    std::printf("%-24s %8.3f ns/value\n", "validate_bulk", bulk / n);
+    return 0;
+}
@@ -0,0 +1,73 @@
+#include "SPSCQueue.h"
+#include "WaitPolicy.h"
+#include "BenchUtil.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+//
+// Enqueue-to-apply latency per wait policy. Each message carries its
+// enqueue timestamp; the consumer loop mirrors ParamWorker::run and
+// records now - stamp when it takes the message off the ring. The
+// producer sleeps between messages so the consumer goes idle and the
+// policy's idle path (spin, yield, park, sleep) is what gets measured.
+//
+namespace
+{
+constexpr std::size_t kSamples = 5000;
+constexpr std::uint64_t kStopStamp = 0;
+
+using Queue = SPSCQueue<std::uint64_t, 1024, QueueLayout::CacheAligned>;
+
+template <typename WaitPolicy>
+void run_policy(const char* name)
+{
+    static Queue q;
+    WaitPolicy wait;
+    std::vector<std::uint64_t> latencies;
+    latencies.reserve(kSamples);
+
+    std::thread consumer([&]
+    {
+        bool running = true;
+        while (running)
+        {
+            auto n = q.pop_bulk([&](std::uint64_t&& stamp)
+            {
+                if (stamp == kStopStamp) running = false;
+                else latencies.push_back(bench::now_ns() - stamp);
+            }, 64);
+            if (n == 0 && running) wait.wait([&] { return !q.empty(); });
+        }
+    });
+
+    for (std::size_t i = 0; i < kSamples; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(20));
+        while (!q.try_push(bench::now_ns())) std::this_thread::yield();
+        wait.notify();
+    }
+    while (!q.try_push(kStopStamp)) std::this_thread::yield();
+    wait.notify();
+    consumer.join();
+
+    std::sort(latencies.begin(), latencies.end());
+    auto pct = [&](double p) { return latencies[static_cast<std::size_t>(p * (latencies.size() - 1))]; };
+    std::printf("%-14s %10llu %10llu %10llu\n", name,
+                static_cast<unsigned long long>(pct(0.50)),
+                static_cast<unsigned long long>(pct(0.99)),
+                static_cast<unsigned long long>(latencies.back()));
+}
+}
+
+int main()
+{
+    std::printf("%-14s %10s %10s %10s\n", "policy", "p50 ns", "p99 ns", "max ns");
+    run_policy<SleepWait<>>("sleep-50us");
+    run_policy<BusySpinWait>("busy-spin");
+    run_policy<SpinYieldWait<>>("spin-yield");
+    run_policy<SpinBlockWait<>>("spin-block");
+    return 0;
+}
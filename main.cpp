@@ -1,181 +1,141 @@
 #include "ParameterTraits.h"
-#include <atomic>
-#include <array>
-#include <chrono>
+#include "ParamMessage.h"
+#include "ParameterTable.h"
+#include "ConfigLoader.h"
+#include "AsyncParams.h"
+#include "ParamLanes.h"
+#include "ParamWorker.h"
 #include <iostream>
-#include <optional>
 #include <thread>
-#include <type_traits>
-#include <utility>
-#include <variant>
-
-//
-// SImple lock-free SPSC (Single Producer Single Consumer ring buffer
-//
-template <typename T, std::size_t CapacityPow2>
-class SPSCQueue
-{
-    static_assert((CapacityPow2 & (CapacityPow2 - 1)) == 0, "Capacity must be power of two.");
-
-public:
-    bool try_push(const T& v) { return try_push(T(v)); }
-
-    bool try_push(T&& v)
-    {
-        const std::size_t head = head_.load(std::memory_order_relaxed);
-        const std::size_t next = (head + 1) & mask_;
-        if (next == tail_.load(std::memory_order_acquire)) return false;
-        buf_[head] = std::move(v);
-        head_.store(next, std::memory_order_release);
-        return true;
-    }
-
-    std::optional<T> try_pop()
-    {
-        const std::size_t tail = tail_.load(std::memory_order_relaxed);
-        if (tail == head_.load(std::memory_order_acquire)) return std::nullopt;
-        T v = std::move(buf_[tail]);
-        tail_.store((tail + 1) & mask_, std::memory_order_release);
-        return v;
-    }
-
-private:
-    static constexpr std::size_t mask_ = CapacityPow2 - 1;
-    std::array<T, CapacityPow2> buf_{};
-    std::atomic<std::size_t> head_{0}, tail_{0};
-};
 
-//
-// Messages (carry full tag types)
-//
-struct Stop {};
-
-template <typename ParamTag>
-struct SetParam
-{
-    ParamTag value{};
-};
-
-//
-// NOT ideal - variant template parameters could grow a lot with
-// a lot of parameters. BUT, we'll stick with this for now because
-// it is simple for demo.  Maybe use a type-erased Msg class later.
-//
-using Msg = std::variant<SetParam<TemperatureSetpoint>,
-                         SetParam<HighTemperatureAlarm>,
-                         SetParam<FanDutyCycle>,
-                         Stop>;
-
-// ------------------------
-// Parameter table using your tag types
-// ------------------------
-struct ParameterTable
+static void print_result(const char* what, const UpdateResult& r)
 {
-    TemperatureSetpoint t { param_default<TemperatureSetpoint>() };
-    HighTemperatureAlarm a { param_default<HighTemperatureAlarm>() };
-    FanDutyCycle         f { param_default<FanDutyCycle>() };
-
-    template <typename Tag>
-    void set(const Tag& v)
-    {
-        if constexpr (std::is_same_v<Tag, TemperatureSetpoint>)
-        {
-            t = v;
-        }
-        else if constexpr (std::is_same_v<Tag, HighTemperatureAlarm>)
-        {
-            a = v;
-        }
-        else if constexpr (std::is_same_v<Tag, FanDutyCycle>)
-        {
-            f = v;
-        }
-    }
-
-    void print() const
-    {
-        char buf[32]{};
-        int n = 0;
-        n = param_serialize(t, buf, sizeof(buf));
-        std::cout << "Params { Tset=" << (n ? buf : "?");
-        n = param_serialize(a, buf, sizeof(buf));
-        std::cout << ", HighAlarm=" << (n ? buf : "?");
-        n = param_serialize(f, buf, sizeof(buf));
-        std::cout << ", FanDuty=" << (n ? buf : "?") << "% }\n";
-    }
-};
+    std::cout << "[Async] " << what << ": " << (r ? "applied" : to_string(r.reason)) << "\n";
+}
 
-// ------------------------
-// Consumer
-// ------------------------
-class ParamWorker
+#if defined(PARAMETER_TRAITS_HAS_COROUTINES)
+// Resumed by AsyncParamClient::poll() once the worker has applied it.
+template <typename Client>
+DetachedTask set_fan(Client& client, float percent)
 {
-public:
-    explicit ParamWorker(SPSCQueue<Msg, 1024>& q, ParameterTable& tbl) : q_(q), table_(tbl) {}
-
-    void start()
-    {
-        running_.store(true);
-        worker_ = std::thread([this] { run(); });
-    }
-    void join() { if (worker_.joinable()) worker_.join(); }
+    const UpdateResult r = co_await client.set_param(FanDutyCycle{ percent });
+    print_result("FanDutyCycle (co_await)", r);
+}
+#endif
 
-private:
-    void run()
+int main(int argc, char** argv)
+{
+    ParameterTable params;
+    if (argc > 1)
     {
-        while (running_.load())
+        auto r = load_config_file(argv[1], params, [](size_t line, ConfigError e, std::string_view text)
         {
-            if (auto m = q_.try_pop()) std::visit([this](auto&& x){ handle(x); }, *m);
-            else std::this_thread::sleep_for(std::chrono::microseconds(50));
-        }
+            std::cout << "[Config] line " << line << ": " << to_string(e) << ": " << text << "\n";
+        });
+        if (!r.opened) std::cout << "[Config] cannot open " << argv[1] << "\n";
     }
-    void handle(const Stop&) { running_.store(false); }
+    params.print();
+    const uint64_t loaded = params.generation();
 
-    template <typename Tag>
-    void handle(const SetParam<Tag>& s)
+    // Report every applied change once per batch.
+    SubscriptionTable subs;
+    ParameterSet all;
+    for (auto const& h : registry) all.insert(h.id);
+    subs.subscribe(all, [](void*, const ChangeSet& changes)
     {
-        if (param_validate(s.value))
+        changes.ids().for_each([&](ParameterID id)
         {
-            table_.set(s.value);
-        }
-        else
-        {
-            char buf[32]{};
-            [[maybe_unused]] int n = param_serialize(s.value, buf, sizeof(buf));
-            std::cout << "[Reject] " << param_name<Tag>() << " value\n";
-        }
-    }
-
-    SPSCQueue<Msg, 1024>& q_;
-    ParameterTable& table_;
-    std::atomic<bool> running_{false};
-    std::thread worker_;
-};
-
-int main()
-{
-    ParameterTable params;
-    params.print();
+            const Handler* h = find_by_id(id);
+            char before[32]{}, after[32]{};
+            h->serialize(changes.old_value(id), before, sizeof(before));
+            h->serialize(changes.new_value(id), after, sizeof(after));
+            std::cout << "[Changed] " << h->name << " " << before << " -> " << after << "\n";
+        });
+    });
 
-    SPSCQueue<Msg, 1024> q;
-    ParamWorker worker(q, params);
+    // The alarm must stay above the setpoint, whichever of the two changes.
+    CrossRuleTable rules;
+    rules.add([](void*, const TxnView& v)
+    {
+        return v.get<HighTemperatureAlarm>().threshold > v.get<TemperatureSetpoint>().value;
+    }, nullptr, parameter_set<HighTemperatureAlarm, TemperatureSetpoint>());
+
+    // Rejections are printed off the worker thread.
+    RejectLog rejects;
+    RejectReporter<> reporter(rejects);
+    reporter.start();
+
+    // Variable-length values travel as pool handles.
+    PayloadPool payloads;
+    BlobTable blobs;
+
+    // Alarm changes overtake anything queued in the Normal or Bulk lanes.
+    using Worker = ParamWorker<ParamLanes<>>;
+    ParamLanes<> q;
+    WorkerConfig cfg;
+    cfg.subscriptions = &subs;
+    cfg.rejects = &rejects;
+    cfg.rules = &rules;
+    cfg.payloads = &payloads;
+    cfg.blobs = &blobs;
+    CompletionRing completions;
+    cfg.completions = &completions;
+    WorkerMetrics metrics;
+    cfg.metrics = &metrics;
+    Worker worker(q, params, cfg);
     worker.start();
 
     std::thread producer([&]
     {
+        // Without ConflationSlots every update is delivered (blocking if
+        // the queue is full), so the invalid one below is seen and rejected.
+        ParamProducer<Worker> sender(worker);
+
         // Aggregate init with your tag types
-        q.try_push(Msg{SetParam<TemperatureSetpoint>{ TemperatureSetpoint{ 37.5f } }});
-        q.try_push(Msg{SetParam<HighTemperatureAlarm>{ HighTemperatureAlarm{ 90.0f } }});
-        q.try_push(Msg{SetParam<FanDutyCycle>{ FanDutyCycle{ 45.0f } }});
+        sender.post(TemperatureSetpoint{ 37.5f });
+        sender.post(with_deadline(Msg{ SetParam<HighTemperatureAlarm>{ { 90.0f } } }, std::chrono::milliseconds(1)));
+        sender.post(FanDutyCycle{ 45.0f });
 
         // Invalid examples (will be rejected)
-        q.try_push(Msg{SetParam<FanDutyCycle>{ FanDutyCycle{ 200.0f } }});
+        sender.post(FanDutyCycle{ 200.0f });
+
+        // Each value is in range, but together they break the rule, so
+        // neither is applied.
+        Transaction<> txn;
+        txn.set(TemperatureSetpoint{ 85.0f });
+        txn.set(HighTemperatureAlarm{ 80.0f });
+        worker.try_post(txn);
+
+        // Only the handle goes through the queue.
+        const std::string_view recipe = "Sourdough, long proof";
+        post_blob<RecipeName>(worker, payloads, recipe.data(), recipe.size());
+
+        // Updates whose outcome comes back to the producer.
+        AsyncParamClient<Worker> client(worker, completions);
+        print_result("TemperatureSetpoint 40.00", client.set_param_sync(TemperatureSetpoint{ 40.0f }));
+#if defined(PARAMETER_TRAITS_HAS_COROUTINES)
+        set_fan(client, 150.0f);
+        while (client.in_flight())
+        {
+            if (client.poll() == 0) std::this_thread::yield();
+        }
+#endif
 
-        q.try_push(Msg{Stop{}});
+        sender.post(Msg{Stop{}});
     });
 
     producer.join();
     worker.join();
+    reporter.stop();
     params.print();
+    const auto recipe = blobs.get<RecipeName>();
+    std::cout << "Recipe: " << std::string_view(recipe.data, recipe.size) << "\n";
+
+    // Only what the worker changed, as a telemetry delta would carry it.
+    char delta[256];
+    if (serialize_set(params, params.changed_since(loaded), delta, sizeof(delta)))
+        std::cout << "Changed since load:\n" << delta;
+    std::cout << "Late alarm updates: " << q.missed(Lane::Critical) << "\n";
+    if constexpr (WorkerMetrics::enabled) std::cout << metrics.snapshot();
     return 0;
 }